@@ -10,11 +10,25 @@
 #include <algorithm>
 #include <cctype>
 #include <climits>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cmath>
+#include <filesystem>
 
 using namespace std;
 
-const int MAX = 1000; // Maximum number of health centers
+const int MAX = 1000; // Initial number of health center ID slots; grows on demand
 const float INF = numeric_limits<float>::infinity();
+const int UNLIMITED_THROUGHPUT = -1;
+const int JOURNAL_COMPACT_THRESHOLD = 1024; // Journal entries replayed before the CSV is rewritten
+const int MINUTES_PER_DAY = 1440;
 
 // HealthCenter structure
 struct HealthCenter {
@@ -26,23 +40,864 @@ struct HealthCenter {
     int capacity;
 };
 
-// Connection structure
-struct Connection {
+// Road structure: the single owner of an undirected connection
+struct Road {
+    int from;
     int to;
     float distance;
     int time;
+    int throughput; // Patients per hour, UNLIMITED_THROUGHPUT when not rated
     string description;
+    bool removed;
+    int profile = -1; // Shared time profile, -1 when travel time is constant
+};
+
+// Connection structure: one traversal direction of a road, with its weights copied for locality
+struct Connection {
+    int to;
+    float distance;
+    int metres; // distance rounded once to whole metres for exact integer routing
+    int time;
+    int throughput;
+    int road; // Index into roads, -1 for generated graphs
+    int profile; // Shared time profile, -1 when travel time is constant
+};
+
+typedef vector<vector<Connection>> Graph;
+
+// One breakpoint of a daily congestion profile: travel time is the road's base time scaled by permille / 1000
+struct ProfilePoint {
+    uint16_t minute;  // Minute of the day, 0-1439
+    uint16_t permille;
+    
+    bool operator<(const ProfilePoint& o) const { return minute != o.minute ? minute < o.minute : permille < o.permille; }
 };
 
 // Global variables
 vector<HealthCenter> centers;
-vector<Connection> adjList[MAX];
+vector<Road> roads;
+Graph adjList(MAX);
+int journalEntries = 0;
+string dataDirectory; // Prefix for every data file; empty means the working directory
+
+// Interned time profiles: profile p owns profilePoints[profileStart[p] .. profileStart[p + 1] - 1].
+// Identical profiles are stored once, so memory grows with distinct profiles, not with roads.
+// profileIds only maps a hash of the points to profile IDs; the points themselves live in the pool.
+vector<ProfilePoint> profilePoints;
+vector<uint32_t> profileStart = {0};
+unordered_multimap<uint64_t, int> profileIds;
+
+// Priority queue used by dijkstra and emergencyRouting
+enum class QueueKind { QuaternaryHeap, RadixHeap };
+QueueKind activeQueue = QueueKind::QuaternaryHeap;
+const float WEIGHT_SCALE = 100.0f; // Radix heap keys are distances in units of 10 m
+
+// Edge weight used by the routing algorithms, fixed before the graph is loaded (--fixed-weights)
+enum class WeightMode { Float, Fixed };
+WeightMode weightMode = WeightMode::Float;
+
+// Float kilometres as read from the CSV
+struct FloatWeight {
+    typedef float Type;
+    static Type infinity() { return INF; }
+    static Type of(const Connection& c) { return c.distance; }
+    static float km(Type w) { return w; }
+};
+
+// Whole metres; sums are exact, so results do not depend on evaluation order or platform
+struct FixedWeight {
+    typedef uint64_t Type;
+    static Type infinity() { return UINT64_MAX; }
+    static Type of(const Connection& c) { return c.metres; }
+    static float km(Type w) { return static_cast<float>(w / 1000.0); }
+};
+
+// Negative lengths would wrap in FixedWeight's unsigned sums, so they count as 0
+int toMetres(float km) {
+    return km > 0 ? static_cast<int>(lround(km * 1000.0)) : 0;
+}
+
+// Indexed 4-ary min-heap with decrease-key; each node is queued at most once
+template <typename K>
+class QuaternaryHeap {
+public:
+    typedef K Key;
+    
+    explicit QuaternaryHeap(int n) : key(n), pos(n, -1) {}
+    
+    bool empty() const { return heap.empty(); }
+    
+    // Insert v, or lower its key if it is already queued
+    void push(int v, K k) {
+        if (pos[v] == -1) {
+            pos[v] = heap.size();
+            heap.push_back(v);
+        } else if (!(k < key[v])) {
+            return;
+        }
+        key[v] = k;
+        siftUp(pos[v]);
+    }
+    
+    int pop() {
+        int top = heap[0];
+        pos[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+    
+    // Make room for node IDs below n; only valid while the heap is empty
+    void resize(int n) {
+        key.resize(n);
+        pos.resize(n, -1);
+    }
+    
+    // Drop everything still queued, leaving the heap ready for reuse
+    void clear() {
+        for (int v : heap) pos[v] = -1;
+        heap.clear();
+    }
+    
+private:
+    vector<int> heap;
+    vector<K> key;
+    vector<int> pos;
+    
+    void siftUp(size_t i) {
+        int v = heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / 4;
+            if (!(key[v] < key[heap[parent]])) break;
+            heap[i] = heap[parent];
+            pos[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+    
+    void siftDown(size_t i) {
+        int v = heap[i];
+        size_t n = heap.size();
+        while (true) {
+            size_t first = 4 * i + 1;
+            if (first >= n) break;
+            size_t best = first;
+            size_t end = min(first + 4, n);
+            for (size_t c = first + 1; c < end; ++c) {
+                if (key[heap[c]] < key[heap[best]]) best = c;
+            }
+            if (!(key[heap[best]] < key[v])) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+};
+
+// Monotone radix heap with decrease-key for integer keys; popped keys never decrease
+class RadixHeap {
+public:
+    typedef uint64_t Key;
+    
+    explicit RadixHeap(int n) : key(n), bucketOf(n, -1), slot(n) {}
+    
+    bool empty() const { return count == 0; }
+    
+    // Insert v, or lower its key if it is already queued (k must be >= last popped key)
+    void push(int v, Key k) {
+        if (count == 0) last = k; // An empty heap can restart from any key, so it is reusable
+        if (bucketOf[v] != -1) {
+            if (k >= key[v]) return;
+            erase(v);
+        }
+        key[v] = k;
+        insert(v);
+    }
+    
+    int pop() {
+        if (buckets[0].empty()) {
+            size_t i = 1;
+            while (buckets[i].empty()) ++i;
+            last = key[buckets[i][0]];
+            for (int v : buckets[i]) last = min(last, key[v]);
+            // Everything in bucket i now lands in a lower bucket relative to the new minimum
+            vector<int> moving;
+            moving.swap(buckets[i]);
+            count -= moving.size();
+            for (int v : moving) insert(v);
+        }
+        int v = buckets[0].back();
+        buckets[0].pop_back();
+        bucketOf[v] = -1;
+        --count;
+        return v;
+    }
+    
+private:
+    vector<int> buckets[65];
+    vector<Key> key;
+    vector<int> bucketOf;
+    vector<int> slot;
+    Key last = 0;
+    size_t count = 0;
+    
+    int bucketIndex(Key k) const {
+        Key diff = k ^ last;
+#if defined(__GNUC__)
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+#else
+        int bits = 0;
+        while (diff) {
+            ++bits;
+            diff >>= 1;
+        }
+        return bits;
+#endif
+    }
+    
+    void insert(int v) {
+        int b = bucketIndex(key[v]);
+        bucketOf[v] = b;
+        slot[v] = buckets[b].size();
+        buckets[b].push_back(v);
+        ++count;
+    }
+    
+    void erase(int v) {
+        auto& bucket = buckets[bucketOf[v]];
+        int moved = bucket.back();
+        bucket[slot[v]] = moved;
+        slot[moved] = slot[v];
+        bucket.pop_back();
+        bucketOf[v] = -1;
+        --count;
+    }
+};
+
+// Dijkstra over adj with any indexed heap; every node is settled exactly once
+template <typename Heap, typename WeightOf>
+void shortestPathTree(const Graph& adj, Heap& pq, int start, vector<typename Heap::Key>& dist,
+                      vector<int>& prev, typename Heap::Key inf, WeightOf weightOf) {
+    dist.assign(adj.size(), inf);
+    prev.assign(adj.size(), -1);
+    dist[start] = 0;
+    pq.push(start, 0);
+    
+    while (!pq.empty()) {
+        int u = pq.pop();
+        for (const auto& c : adj[u]) {
+            typename Heap::Key candidate = dist[u] + weightOf(c);
+            if (candidate < dist[c.to]) {
+                dist[c.to] = candidate;
+                prev[c.to] = u;
+                pq.push(c.to, candidate);
+            }
+        }
+    }
+}
+
+// Results returned by the headless graph functions
+struct PathResult {
+    bool found;
+    float distance;
+    vector<int> path;
+};
+
+struct AllPairsResult {
+    vector<int> ids;                 // Center ID for each row/column
+    vector<vector<float>> dist;
+    vector<vector<int>> next;        // Next hop index for path reconstruction, -1 if unreachable
+};
+
+struct MSTResult {
+    vector<pair<int, int>> edges;
+    float totalWeight;
+};
+
+struct EmergencyResult {
+    bool found;
+    int nearestID;
+    float distance;
+    vector<int> path;
+};
+
+struct TimedRoute {
+    bool found;
+    double departure; // Absolute minutes from midnight of the departure day
+    double arrival;
+    vector<int> path;
+};
+
+// Single points of failure in the network
+struct ResilienceReport {
+    vector<int> articulationPoints;
+    vector<pair<int, int>> bridges;
+};
+
+// Dinic max-flow over flat CSR residual arrays; each arc is paired with its reverse
+class MaxFlow {
+public:
+    explicit MaxFlow(int n) : n(n) {}
+    
+    // Returns an arc ID that can be passed to flowOn after solving
+    int addArc(int u, int v, int64_t capacity) {
+        pending.push_back({u, v, capacity});
+        return pending.size() - 1;
+    }
+    
+    int64_t solve(int s, int t) {
+        build();
+        int64_t total = 0;
+        vector<int> path;
+        while (buildLevels(s, t)) {
+            iter.assign(first.begin(), first.end() - 1);
+            path.clear();
+            int u = s;
+            while (true) {
+                if (u == t) {
+                    int64_t push = numeric_limits<int64_t>::max();
+                    for (int a : path) push = min(push, cap[a]);
+                    for (int a : path) {
+                        cap[a] -= push;
+                        cap[rev[a]] += push;
+                    }
+                    total += push;
+                    // Resume from the tail of the first arc this augmentation saturated
+                    size_t k = 0;
+                    while (cap[path[k]] > 0) ++k;
+                    u = to[rev[path[k]]];
+                    path.resize(k);
+                    continue;
+                }
+                int& i = iter[u];
+                while (i < first[u + 1] && !(cap[i] > 0 && level[to[i]] == level[u] + 1)) ++i;
+                if (i < first[u + 1]) {
+                    path.push_back(i);
+                    u = to[i];
+                } else {
+                    level[u] = -1; // Dead end for the rest of this phase
+                    if (path.empty()) break;
+                    u = to[rev[path.back()]];
+                    path.pop_back();
+                }
+            }
+        }
+        return total;
+    }
+    
+    int64_t flowOn(int arc) const { return pending[arc].capacity - cap[position[arc]]; }
+    int64_t capacityOf(int arc) const { return pending[arc].capacity; }
+    
+    // After solve: true if v is on the source side of the minimum cut
+    bool sourceSide(int v) const { return level[v] != -1; }
+    
+private:
+    struct Arc {
+        int from;
+        int to;
+        int64_t capacity;
+    };
+    
+    int n;
+    vector<Arc> pending;
+    vector<int> first; // CSR offsets: arcs leaving u are first[u] .. first[u + 1] - 1
+    vector<int> to;
+    vector<int> rev;
+    vector<int64_t> cap;
+    vector<int> position;
+    vector<int> level;
+    vector<int> iter;
+    
+    void build() {
+        first.assign(n + 1, 0);
+        for (const auto& a : pending) {
+            first[a.from + 1]++;
+            first[a.to + 1]++;
+        }
+        for (int v = 0; v < n; ++v) first[v + 1] += first[v];
+        
+        vector<int> fill(first.begin(), first.end() - 1);
+        to.assign(first[n], 0);
+        rev.assign(first[n], 0);
+        cap.assign(first[n], 0);
+        position.assign(pending.size(), 0);
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const Arc& a = pending[i];
+            int f = fill[a.from]++;
+            int r = fill[a.to]++;
+            to[f] = a.to;
+            cap[f] = a.capacity;
+            rev[f] = r;
+            to[r] = a.from;
+            cap[r] = 0;
+            rev[r] = f;
+            position[i] = f;
+        }
+    }
+    
+    bool buildLevels(int s, int t) {
+        level.assign(n, -1);
+        vector<int> queue = {s};
+        level[s] = 0;
+        for (size_t qi = 0; qi < queue.size(); ++qi) {
+            int u = queue[qi];
+            for (int i = first[u]; i < first[u + 1]; ++i) {
+                if (cap[i] > 0 && level[to[i]] == -1) {
+                    level[to[i]] = level[u] + 1;
+                    queue.push_back(to[i]);
+                }
+            }
+        }
+        return level[t] != -1;
+    }
+};
+
+// Accumulates output in memory and hands it to the stream in large blocks
+class BufferedWriter {
+public:
+    explicit BufferedWriter(ostream& out, size_t capacity = 1 << 16) : out(out), capacity(capacity) {
+        buffer.reserve(capacity);
+    }
+    
+    ~BufferedWriter() { flush(); }
+    
+    void append(const string& text) {
+        buffer += text;
+        if (buffer.size() >= capacity) flush();
+    }
+    
+    void flush() {
+        if (buffer.empty()) return;
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+        buffer.clear();
+    }
+    
+private:
+    ostream& out;
+    size_t capacity;
+    string buffer;
+};
+
+// Left-aligned field like setw: pads short text, never truncates
+void appendPadded(string& out, const string& text, size_t width) {
+    out += text;
+    if (text.size() < width) out.append(width - text.size(), ' ');
+}
+
+// Point-to-point Dijkstra whose buffers survive across calls; only touched slots are reset
+template <typename W>
+struct DijkstraWorkspace {
+    typedef typename W::Type Weight;
+    vector<Weight> dist;
+    vector<int> prev;
+    vector<int> touched;
+    vector<char> blocked;
+    QuaternaryHeap<Weight> pq;
+    
+    explicit DijkstraWorkspace(int n) : dist(n, W::infinity()), prev(n, -1), blocked(n, 0), pq(n) {}
+    
+    // Shortest source->target path avoiding blocked nodes and the edges source->bannedNext
+    bool run(const Graph& adj, int source, int target, const vector<int>& bannedNext, vector<int>& path, Weight& length) {
+        const Weight inf = W::infinity();
+        for (int v : touched) {
+            dist[v] = inf;
+            prev[v] = -1;
+        }
+        touched.clear();
+        
+        dist[source] = 0;
+        touched.push_back(source);
+        pq.push(source, 0);
+        
+        while (!pq.empty()) {
+            int u = pq.pop();
+            if (u == target) break;
+            for (const auto& c : adj[u]) {
+                if (blocked[c.to]) continue;
+                if (u == source && find(bannedNext.begin(), bannedNext.end(), c.to) != bannedNext.end()) continue;
+                Weight candidate = dist[u] + W::of(c);
+                if (candidate < dist[c.to]) {
+                    if (dist[c.to] == inf) touched.push_back(c.to);
+                    dist[c.to] = candidate;
+                    prev[c.to] = u;
+                    pq.push(c.to, candidate);
+                }
+            }
+        }
+        pq.clear();
+        
+        if (dist[target] == inf) return false;
+        length = dist[target];
+        path.clear();
+        for (int at = target; at != -1; at = prev[at]) {
+            path.push_back(at);
+        }
+        reverse(path.begin(), path.end());
+        return true;
+    }
+};
+
+// Spur-search threads and their workspaces, kept alive across kShortestPaths calls so a query
+// neither allocates O(V) buffers nor starts threads. Worker 0 is the calling thread.
+template <typename W>
+class SpurWorkers {
+public:
+    ~SpurWorkers() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : pool) t.join();
+    }
+    
+    // At least count workspaces sized for an n-node graph and count - 1 waiting threads
+    void prepare(unsigned count, int n) {
+        if (n != nodes) {
+            workspaces.clear();
+            nodes = n;
+        }
+        while (workspaces.size() < count) workspaces.emplace_back(n);
+        while (pool.size() + 1 < count) {
+            unsigned w = pool.size() + 1;
+            pool.emplace_back([this, w]() { loop(w); });
+        }
+    }
+    
+    DijkstraWorkspace<W>& workspace(unsigned w) { return workspaces[w]; }
+    
+    // Run job(0) .. job(active - 1) in parallel and return once all have finished
+    void run(unsigned active, const function<void(unsigned)>& work) {
+        if (active <= 1) {
+            work(0);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(m);
+            job = &work;
+            running = active;
+            pending = active - 1;
+            ++generation;
+        }
+        wake.notify_all();
+        work(0);
+        unique_lock<mutex> lock(m);
+        finished.wait(lock, [&]() { return pending == 0; });
+    }
+    
+private:
+    vector<DijkstraWorkspace<W>> workspaces;
+    int nodes = -1;
+    vector<thread> pool;
+    mutex m;
+    condition_variable wake, finished;
+    const function<void(unsigned)>* job = nullptr;
+    unsigned running = 0, pending = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    
+    void loop(unsigned w) {
+        uint64_t seen = 0;
+        unique_lock<mutex> lock(m);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (w >= running) continue;
+            const function<void(unsigned)>* work = job;
+            lock.unlock();
+            (*work)(w);
+            lock.lock();
+            if (--pending == 0) finished.notify_all();
+        }
+    }
+};
+
+// One loopless route with its total length in km
+struct RoutePath {
+    float length;
+    vector<int> nodes;
+};
+
+// Shortest-path tree from a hub center, repaired in place after road edits
+struct HubTree {
+    int source;
+    vector<float> dist;
+    vector<int> parent;
+    QuaternaryHeap<float> pq;
+    
+    explicit HubTree(int s) : source(s), pq(adjList.size()) {}
+};
+
+vector<HubTree> hubTrees;
+
+// Road network cut along district lines. Each district owns a contiguous block holding its
+// intra-district roads in CSR form and a cell of boundary-to-boundary distances; cross-district
+// queries search only the cells and the roads between districts.
+template <typename W>
+class DistrictOverlay {
+public:
+    typedef typename W::Type Weight;
+    
+    bool ready() const { return built; }
+    
+    void build() {
+        map<string, int> indexOf;
+        for (const auto& hc : centers) indexOf.emplace(hc.district, indexOf.size());
+        blocks.assign(indexOf.size(), Block());
+        blockOf.assign(adjList.size(), -1);
+        localOf.assign(adjList.size(), -1);
+        boundaryIndex.assign(adjList.size(), -1);
+        for (const auto& hc : centers) {
+            Block& b = blocks[indexOf[hc.district]];
+            blockOf[hc.id] = indexOf[hc.district];
+            localOf[hc.id] = b.nodes.size();
+            b.nodes.push_back(hc.id);
+        }
+        for (size_t d = 0; d < blocks.size(); ++d) rebuildBlock(d);
+        numberBoundaries();
+        built = true;
+    }
+    
+    // A center was added, removed or moved to another district
+    void invalidate() { built = false; }
+    
+    // The road between a and b changed; only the districts at its ends need new cells
+    void roadChanged(int a, int b) {
+        if (!built) return;
+        for (int v : {a, b}) {
+            if (v < static_cast<int>(blockOf.size()) && blockOf[v] != -1) blocks[blockOf[v]].dirty = true;
+        }
+    }
+    
+    size_t districts() const { return blocks.size(); }
+    
+    size_t boundaryNodes() const { return boundaryOffset.empty() ? 0 : boundaryOffset.back(); }
+    
+    size_t cellEntries() const {
+        size_t total = 0;
+        for (const auto& b : blocks) total += b.cell.size();
+        return total;
+    }
+    
+    // Shortest route between two centers; builds or repairs cells as needed
+    bool route(int s, int t, Weight& length, vector<int>& path) {
+        if (!built) build();
+        bool repaired = false;
+        for (size_t d = 0; d < blocks.size(); ++d) {
+            if (blocks[d].dirty) {
+                rebuildBlock(d);
+                repaired = true;
+            }
+        }
+        if (repaired) numberBoundaries();
+        
+        const Weight inf = W::infinity();
+        int ds = blockOf[s], dt = blockOf[t];
+        const Block& source = blocks[ds];
+        const Block& target = blocks[dt];
+        vector<Weight> distS, distT;
+        vector<int> prevS, prevT;
+        localSearch(source, localOf[s], distS, prevS);
+        localSearch(target, localOf[t], distT, prevT);
+        
+        Weight best = ds == dt ? distS[localOf[t]] : inf;
+        int bestExit = -1; // Overlay node the route leaves the overlay from, -1 for a purely local route
+        
+        // Overlay nodes are numbered boundaryOffset[d] + i for the i-th boundary node of district d
+        size_t n = boundaryNodes();
+        vector<Weight> label(n, inf);
+        vector<int> pred(n, -1);
+        QuaternaryHeap<Weight> pq(n);
+        for (size_t i = 0; i < source.boundary.size(); ++i) {
+            Weight d = distS[source.boundary[i]];
+            if (d == inf) continue;
+            label[boundaryOffset[ds] + i] = d;
+            pq.push(boundaryOffset[ds] + i, d);
+        }
+        
+        while (!pq.empty()) {
+            int u = pq.pop();
+            if (label[u] >= best) break;
+            int d = upper_bound(boundaryOffset.begin(), boundaryOffset.end(), u) - boundaryOffset.begin() - 1;
+            const Block& block = blocks[d];
+            size_t i = u - boundaryOffset[d], nb = block.boundary.size();
+            
+            if (d == dt && distT[block.boundary[i]] != inf && label[u] + distT[block.boundary[i]] < best) {
+                best = label[u] + distT[block.boundary[i]];
+                bestExit = u;
+            }
+            auto relax = [&](int v, Weight w) {
+                if (label[u] + w < label[v]) {
+                    label[v] = label[u] + w;
+                    pred[v] = u;
+                    pq.push(v, label[v]);
+                }
+            };
+            for (size_t j = 0; j < nb; ++j) {
+                if (j != i && block.cell[i * nb + j] != inf) relax(boundaryOffset[d] + j, block.cell[i * nb + j]);
+            }
+            for (const auto& c : adjList[block.nodes[block.boundary[i]]]) {
+                int e = blockOf[c.to];
+                if (e != -1 && e != d) relax(boundaryOffset[e] + boundaryIndex[c.to], W::of(c));
+            }
+        }
+        if (best == inf) return false;
+        length = best;
+        
+        path.clear();
+        if (bestExit == -1) {
+            localPath(source, prevS, localOf[t], path);
+            return true;
+        }
+        vector<int> chain;
+        for (int u = bestExit; u != -1; u = pred[u]) chain.push_back(u);
+        reverse(chain.begin(), chain.end());
+        
+        localPath(source, prevS, blocks[ds].boundary[chain[0] - boundaryOffset[ds]], path);
+        for (size_t k = 1; k < chain.size(); ++k) {
+            int v = globalOf(chain[k]);
+            if (blockOf[v] == blockOf[path.back()]) {
+                // Cell entry: expand it with a search inside the district
+                const Block& block = blocks[blockOf[v]];
+                vector<Weight> dist;
+                vector<int> prev, leg;
+                localSearch(block, localOf[path.back()], dist, prev);
+                localPath(block, prev, localOf[v], leg);
+                path.insert(path.end(), leg.begin() + 1, leg.end());
+            } else {
+                path.push_back(v);
+            }
+        }
+        // prevT points towards t, so following it from the exit node walks the final leg forwards
+        for (int v = localOf[path.back()]; prevT[v] != -1; ) {
+            v = prevT[v];
+            path.push_back(target.nodes[v]);
+        }
+        return true;
+    }
+    
+private:
+    struct Block {
+        vector<int> nodes;      // Local index -> center ID
+        vector<int> first;      // Intra-district roads of local u are first[u] .. first[u + 1] - 1
+        vector<int> arcTo;
+        vector<Weight> arcWeight;
+        vector<int> boundary;   // Local indices with a road to another district
+        vector<Weight> cell;    // boundary.size() x boundary.size() distances inside the district
+        bool dirty = false;
+    };
+    
+    vector<Block> blocks;
+    vector<int> blockOf;       // Center ID -> district block, -1 if not a center
+    vector<int> localOf;       // Center ID -> index within its block
+    vector<int> boundaryIndex; // Center ID -> index in its block's boundary list, -1 for interior nodes
+    vector<int> boundaryOffset;
+    bool built = false;
+    
+    int globalOf(int overlayNode) const {
+        int d = upper_bound(boundaryOffset.begin(), boundaryOffset.end(), overlayNode) - boundaryOffset.begin() - 1;
+        return blocks[d].nodes[blocks[d].boundary[overlayNode - boundaryOffset[d]]];
+    }
+    
+    void numberBoundaries() {
+        boundaryOffset.assign(blocks.size() + 1, 0);
+        for (size_t d = 0; d < blocks.size(); ++d) boundaryOffset[d + 1] = boundaryOffset[d] + blocks[d].boundary.size();
+    }
+    
+    void rebuildBlock(int d) {
+        Block& b = blocks[d];
+        for (int u : b.boundary) boundaryIndex[b.nodes[u]] = -1;
+        b.boundary.clear();
+        b.first.assign(1, 0);
+        b.arcTo.clear();
+        b.arcWeight.clear();
+        for (size_t u = 0; u < b.nodes.size(); ++u) {
+            bool leaves = false;
+            for (const auto& c : adjList[b.nodes[u]]) {
+                if (blockOf[c.to] == d) {
+                    b.arcTo.push_back(localOf[c.to]);
+                    b.arcWeight.push_back(W::of(c));
+                } else if (blockOf[c.to] != -1) {
+                    leaves = true;
+                }
+            }
+            b.first.push_back(b.arcTo.size());
+            if (leaves) {
+                boundaryIndex[b.nodes[u]] = b.boundary.size();
+                b.boundary.push_back(u);
+            }
+        }
+        
+        size_t nb = b.boundary.size();
+        b.cell.assign(nb * nb, W::infinity());
+        vector<Weight> dist;
+        vector<int> prev;
+        for (size_t i = 0; i < nb; ++i) {
+            localSearch(b, b.boundary[i], dist, prev);
+            for (size_t j = 0; j < nb; ++j) b.cell[i * nb + j] = dist[b.boundary[j]];
+        }
+        b.dirty = false;
+    }
+    
+    // Dijkstra restricted to one district, over local indices
+    void localSearch(const Block& b, int start, vector<Weight>& dist, vector<int>& prev) const {
+        dist.assign(b.nodes.size(), W::infinity());
+        prev.assign(b.nodes.size(), -1);
+        QuaternaryHeap<Weight> pq(b.nodes.size());
+        dist[start] = 0;
+        pq.push(start, 0);
+        while (!pq.empty()) {
+            int u = pq.pop();
+            for (int a = b.first[u]; a < b.first[u + 1]; ++a) {
+                if (dist[u] + b.arcWeight[a] < dist[b.arcTo[a]]) {
+                    dist[b.arcTo[a]] = dist[u] + b.arcWeight[a];
+                    prev[b.arcTo[a]] = u;
+                    pq.push(b.arcTo[a], dist[b.arcTo[a]]);
+                }
+            }
+        }
+    }
+    
+    // Center IDs from the search root to local node end
+    void localPath(const Block& b, const vector<int>& prev, int end, vector<int>& out) const {
+        vector<int> leg;
+        for (int v = end; v != -1; v = prev[v]) leg.push_back(b.nodes[v]);
+        out.insert(out.end(), leg.rbegin(), leg.rend());
+    }
+};
+
+template <typename W>
+DistrictOverlay<W>& districtOverlay() {
+    static DistrictOverlay<W> overlay;
+    return overlay;
+}
 
 // Function prototypes
+string dataPath(const string& file);
+void reserveNodeSlot(int id);
+void generateNetwork(int nodes, unsigned seed);
+void resetNetwork();
+void benchmarkSuite(const vector<int>& sizes, unsigned seed);
 void readHealthCenters();
 void saveHealthCenters();
 void readConnections();
 void saveConnections();
+int addRoad(const Road& r);
+void updateRoad(int r);
+void deleteRoad(int r);
+int findRoad(int a, int b);
+void appendJournal(char op, const Road& r);
+void replayJournal();
 void addHealthCenter();
 void editHealthCenter();
 void viewHealthCenters();
@@ -58,16 +913,148 @@ bool detectCycle();
 void floydWarshall();
 void primMST(int start);
 void emergencyRouting(int minCapacity);
+vector<int> tracePath(const vector<int>& prev, int end);
+void printPath(const vector<int>& path);
+PathResult shortestPath(int start, int end);
+template <typename W> PathResult shortestPath(int start, int end);
+vector<int> bfsOrder(int start);
+AllPairsResult allPairsShortestPaths();
+template <typename W> AllPairsResult allPairsShortestPaths();
+MSTResult minimumSpanningTree(int start);
+template <typename W> MSTResult minimumSpanningTree(int start);
+EmergencyResult nearestWithCapacity(int start, int minCapacity);
+template <typename W> EmergencyResult nearestWithCapacity(int start, int minCapacity);
+void runBatch(const string& queryFile, const string& resultFile);
+template <typename W> void shortestPaths(int start, vector<typename W::Type>& dist, vector<int>& prev);
+void selectPriorityQueue();
+void benchmarkQueues(int nodes, int queries, unsigned seed);
+Graph generateRoadGrid(int nodes, unsigned seed, size_t& edges);
+template <typename W> typename W::Type roadLength(const Graph& adj, int u, int v);
+vector<RoutePath> kShortestPaths(const Graph& adj, int source, int target, int k, unsigned threads);
+template <typename W> vector<RoutePath> kShortestPaths(const Graph& adj, int source, int target, int k, unsigned threads);
+void alternativeRoutes();
+void benchmarkAlternativeRoutes(int nodes, int pairs, unsigned seed);
+void readHubs();
+void saveHubs();
+void rebuildHubTrees();
+void repairHubTree(HubTree& tree, int a, int b);
+void repairHubTrees(int a, int b);
+void manageHubs();
+void hubDispatch();
+vector<int> buildCapacityIndex();
+vector<pair<int, int>> isochrone(int start, int maxMinutes, int minCapacity, const vector<int>& capacityOf);
+void viewIsochrone();
+void isochroneCoverage();
+template <typename W> bool referralCatchments(int minCapacity, vector<float>& km, vector<int>& source);
+void catchmentAssignment(int minCapacity);
+PathResult overlayPath(int start, int end);
+template <typename W> PathResult overlayPath(int start, int end);
+void overlayRoadChanged(int a, int b);
+void invalidateOverlay();
+void partitionedRoute();
+int internProfile(const vector<ProfilePoint>& points);
+bool parseProfile(const string& text, vector<ProfilePoint>& points);
+string formatProfile(int profile);
+bool profileIsFifo(const ProfilePoint* points, int n, int baseMinutes);
+bool profileIsFifo(int profile, int baseMinutes);
+void readRoadProfiles();
+void saveRoadProfiles();
+double travelMinutes(const Connection& c, double at);
+TimedRoute fastestRouteAt(int start, int end, double departure);
+int parseClock(const string& text);
+string formatClock(double minutes);
+void timeDependentRoute();
+void setRoadProfile();
 bool centerExists(int id);
 bool isValidNumber(const string& str);
 bool isValidFloat(const string& str);
 void trim(string& str);
 bool detectCycleDFS(int v, vector<bool>& visited, vector<bool>& recStack, int parent);
+ResilienceReport findCriticalPoints(const Graph& adj, const vector<int>& nodes);
+void districtTransferCapacity();
+vector<double> betweennessCentrality(const Graph& adj, const vector<int>& nodes, const vector<int>& sources, unsigned threads);
+template <typename W> vector<double> betweennessCentrality(const Graph& adj, const vector<int>& nodes, const vector<int>& sources, unsigned threads);
+void betweennessRanking();
+void networkResilience();
 
 // Main menu
-int main() {
+int main(int argc, char* argv[]) {
+    // --fixed-weights may precede any mode; it must be set before the graph is loaded
+    if (argc > 1 && string(argv[1]) == "--fixed-weights") {
+        weightMode = WeightMode::Fixed;
+        argv[1] = argv[0];
+        ++argv;
+        --argc;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-queues") {
+        if ((argc > 2 && (!isValidNumber(argv[2]) || stoi(argv[2]) <= 0)) ||
+            (argc > 3 && (!isValidNumber(argv[3]) || stoi(argv[3]) <= 0)) ||
+            (argc > 4 && (!isValidNumber(argv[4]) || stoi(argv[4]) < 0))) {
+            cout << "Usage: " << argv[0] << " --bench-queues [nodes > 0] [queries > 0] [seed >= 0]\n";
+            return 1;
+        }
+        int nodes = argc > 2 ? stoi(argv[2]) : 100000;
+        int queries = argc > 3 ? stoi(argv[3]) : 20;
+        unsigned seed = argc > 4 ? stoul(argv[4]) : 42;
+        benchmarkQueues(nodes, queries, seed);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--generate") {
+        if (argc < 3) {
+            cout << "Usage: " << argv[0] << " --generate <nodes> [seed]\n";
+            return 1;
+        }
+        if (!isValidNumber(argv[2]) || stoi(argv[2]) <= 0) {
+            cout << "Error: Node count must be a positive number.\n";
+            return 1;
+        }
+        generateNetwork(stoi(argv[2]), argc > 3 ? stoul(argv[3]) : 42);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        // --bench [seed] [sizes...]; data files go to bench_data/ so real ones are never overwritten
+        unsigned seed = argc > 2 ? stoul(argv[2]) : 42;
+        vector<int> sizes;
+        for (int i = 3; i < argc; ++i) {
+            if (!isValidNumber(argv[i]) || stoi(argv[i]) <= 0) {
+                cout << "Error: Node count must be a positive number.\n";
+                return 1;
+            }
+            sizes.push_back(stoi(argv[i]));
+        }
+        if (sizes.empty()) sizes = {1000, 10000, 100000};
+        benchmarkSuite(sizes, seed);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        if (argc < 4) {
+            cout << "Usage: " << argv[0] << " --batch <queries.txt> <results.csv>\n";
+            return 1;
+        }
+        readHealthCenters();
+        readConnections();
+        readRoadProfiles();
+        runBatch(argv[2], argv[3]);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-yen") {
+        if ((argc > 2 && (!isValidNumber(argv[2]) || stoi(argv[2]) < 0)) ||
+            (argc > 3 && (!isValidNumber(argv[3]) || stoi(argv[3]) <= 0)) ||
+            (argc > 4 && (!isValidNumber(argv[4]) || stoi(argv[4]) < 0))) {
+            cout << "Usage: " << argv[0] << " --bench-yen [nodes >= 0, 0 for the CSV network] [pairs > 0] [seed >= 0]\n";
+            return 1;
+        }
+        int nodes = argc > 2 ? stoi(argv[2]) : 0; // 0 benchmarks the network in the CSV files
+        int pairs = argc > 3 ? stoi(argv[3]) : 20;
+        unsigned seed = argc > 4 ? stoul(argv[4]) : 42;
+        benchmarkAlternativeRoutes(nodes, pairs, seed);
+        return 0;
+    }
+    
     readHealthCenters();
     readConnections();
+    readRoadProfiles();
+    readHubs();
     
     int choice;
     do {
@@ -87,6 +1074,19 @@ int main() {
         cout << "13. Floyd-Warshall All-Pairs\n";
         cout << "14. Prim's MST\n";
         cout << "15. Emergency Routing\n";
+        cout << "16. Reachable Within T Minutes\n";
+        cout << "17. Coverage Report (All Centers)\n";
+        cout << "18. Referral Catchment Assignment\n";
+        cout << "19. Select Priority Queue\n";
+        cout << "20. Manage Dispatch Hubs\n";
+        cout << "21. Hub Dispatch Route\n";
+        cout << "22. Alternative Routes (K Shortest)\n";
+        cout << "23. Network Resilience (Cut Points & Bridges)\n";
+        cout << "24. Max Patient Transfer Between Districts\n";
+        cout << "25. Betweenness Centrality Ranking\n";
+        cout << "26. Fastest Route by Departure Time\n";
+        cout << "27. Set Road Time Profile\n";
+        cout << "28. Partitioned Route (District Overlay)\n";
         cout << "0. Exit\n";
         cout << "Enter choice: ";
         
@@ -144,7 +1144,29 @@ int main() {
                 emergencyRouting(stoi(input));
                 break;
             }
-            case 0: cout << "Exiting program...\n"; break;
+            case 16: viewIsochrone(); break;
+            case 17: isochroneCoverage(); break;
+            case 18: {
+                cout << "Enter minimum referral capacity: ";
+                getline(cin, input);
+                if (!isValidNumber(input)) { cout << "Invalid capacity.\n"; break; }
+                catchmentAssignment(stoi(input));
+                break;
+            }
+            case 19: selectPriorityQueue(); break;
+            case 20: manageHubs(); break;
+            case 21: hubDispatch(); break;
+            case 22: alternativeRoutes(); break;
+            case 23: networkResilience(); break;
+            case 24: districtTransferCapacity(); break;
+            case 25: betweennessRanking(); break;
+            case 26: timeDependentRoute(); break;
+            case 27: setRoadProfile(); break;
+            case 28: partitionedRoute(); break;
+            case 0:
+                if (journalEntries > 0) saveConnections();
+                cout << "Exiting program...\n";
+                break;
             default: cout << "Invalid choice. Try again.\n";
         }
     } while (choice != 0);
@@ -152,11 +1174,187 @@ int main() {
     return 0;
 }
 
+// Location of a data file inside dataDirectory
+string dataPath(const string& file) {
+    return dataDirectory + file;
+}
+
+// Grow every ID-indexed structure so that id is a valid slot
+void reserveNodeSlot(int id) {
+    if (id < static_cast<int>(adjList.size())) return;
+    size_t n = max<size_t>(id + 1, adjList.size() * 2);
+    adjList.resize(n);
+    for (auto& t : hubTrees) {
+        t.dist.resize(n, INF);
+        t.parent.resize(n, -1);
+        t.pq.resize(n);
+    }
+}
+
+// Seeded planar-ish road network over Uganda's extent, written as health_centers.csv and connections.csv
+void generateNetwork(int nodes, unsigned seed) {
+    const double LAT_MIN = -1.48, LAT_MAX = 4.23, LON_MIN = 29.57, LON_MAX = 35.04;
+    const double EARTH_RADIUS_KM = 6371.0;
+    const double PI = 3.14159265358979323846;
+    
+    int side = max(1, static_cast<int>(ceil(sqrt(static_cast<double>(nodes)))));
+    int districtsPerSide = max(1, min(12, side / 10));
+    int blockSide = (side + districtsPerSide - 1) / districtsPerSide;
+    double latStep = (LAT_MAX - LAT_MIN) / side;
+    double lonStep = (LON_MAX - LON_MIN) / side;
+    
+    mt19937 rng(seed);
+    uniform_real_distribution<double> jitter(-0.35, 0.35);
+    uniform_real_distribution<double> detour(1.1, 1.4);
+    uniform_real_distribution<double> speed(25.0, 70.0);
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    uniform_int_distribution<int> smallCapacity(20, 150);
+    uniform_int_distribution<int> referralCapacity(200, 1000);
+    uniform_int_distribution<int> throughput(20, 200);
+    
+    // Node v (ID v + 1) sits near grid cell (v / side, v % side)
+    vector<float> lat(nodes), lon(nodes);
+    ofstream centersFile(dataPath("health_centers.csv"));
+    BufferedWriter centersOut(centersFile);
+    centersOut.append("ID,Name,District,Latitude,Longitude,Capacity\n");
+    char row[160];
+    for (int v = 0; v < nodes; ++v) {
+        int r = v / side, c = v % side;
+        lat[v] = LAT_MIN + (r + 0.5 + jitter(rng)) * latStep;
+        lon[v] = LON_MIN + (c + 0.5 + jitter(rng)) * lonStep;
+        int district = (r / blockSide) * districtsPerSide + c / blockSide + 1;
+        int capacity = chance(rng) < 0.1 ? referralCapacity(rng) : smallCapacity(rng);
+        snprintf(row, sizeof(row), "%d,HC %d,District %d,%.4f,%.4f,%d\n", v + 1, v + 1, district, lat[v], lon[v], capacity);
+        centersOut.append(row);
+    }
+    centersOut.flush();
+    centersFile.close();
+    
+    auto haversine = [&](int a, int b) {
+        double dLat = (lat[b] - lat[a]) * PI / 180, dLon = (lon[b] - lon[a]) * PI / 180;
+        double h = sin(dLat / 2) * sin(dLat / 2) + cos(lat[a] * PI / 180) * cos(lat[b] * PI / 180) * sin(dLon / 2) * sin(dLon / 2);
+        return 2 * EARTH_RADIUS_KM * asin(sqrt(h));
+    };
+    
+    ofstream roadsFile(dataPath("connections.csv"));
+    BufferedWriter roadsOut(roadsFile);
+    roadsOut.append("FromID,ToID,DistanceKM,TimeMinutes,ThroughputPerHour,Description\n");
+    size_t edges = 0;
+    auto link = [&](int a, int b) {
+        double km = haversine(a, b) * detour(rng);
+        int minutes = max(1, static_cast<int>(lround(km / speed(rng) * 60)));
+        snprintf(row, sizeof(row), "%d,%d,%.2f,%d,%d,Road %zu\n", a + 1, b + 1, km, minutes, throughput(rng), edges + 1);
+        roadsOut.append(row);
+        ++edges;
+    };
+    // Grid streets with some missing blocks plus one diagonal direction keeps the graph close to planar
+    for (int v = 0; v < nodes; ++v) {
+        int c = v % side;
+        if (c + 1 < side && v + 1 < nodes && chance(rng) < 0.85) link(v, v + 1);
+        if (v + side < nodes && chance(rng) < 0.85) link(v, v + side);
+        if (c + 1 < side && v + side + 1 < nodes && chance(rng) < 0.1) link(v, v + side + 1);
+    }
+    roadsOut.flush();
+    roadsFile.close();
+    
+    // A stale journal or profile list would otherwise be applied on top of the fresh network
+    ofstream journal(dataPath("connections.journal"), ios::trunc);
+    ofstream profiles(dataPath("road_profiles.csv"), ios::trunc);
+    cout << "Generated " << nodes << " health centers and " << edges << " roads (seed " << seed << ")\n";
+}
+
+// Forget the loaded network so another one can be read
+void resetNetwork() {
+    centers.clear();
+    roads.clear();
+    hubTrees.clear();
+    adjList.assign(MAX, {});
+    journalEntries = 0;
+    invalidateOverlay();
+}
+
+// Time load, save and each algorithm on generated networks; CSV rows on stdout for regression tracking
+void benchmarkSuite(const vector<int>& sizes, unsigned seed) {
+    const int QUERIES = 10;
+    const size_t FLOYD_LIMIT = 2000; // O(V^3) beyond this is impractical
+    filesystem::create_directories("bench_data");
+    dataDirectory = "bench_data/";
+    
+    cout << "nodes,edges,operation,runs,total_ms,mean_ms\n";
+    for (int nodes : sizes) {
+        size_t edges = 0;
+        auto report = [&](const string& op, int runs, chrono::steady_clock::time_point t0) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            cout << nodes << "," << edges << "," << op << "," << runs << "," << fixed << setprecision(3)
+                 << ms << "," << ms / max(1, runs) << "\n" << flush;
+        };
+        
+        // Generator chatter goes to a sink so stdout stays machine-readable
+        streambuf* saved = cout.rdbuf(nullptr);
+        generateNetwork(nodes, seed);
+        cout.rdbuf(saved);
+        
+        resetNetwork();
+        auto t0 = chrono::steady_clock::now();
+        readHealthCenters();
+        readConnections();
+        edges = roads.size();
+        report("load", 1, t0);
+        
+        t0 = chrono::steady_clock::now();
+        saveHealthCenters();
+        saveConnections();
+        report("save", 1, t0);
+        
+        mt19937 rng(seed + nodes);
+        uniform_int_distribution<size_t> pick(0, centers.size() - 1);
+        vector<int> starts, ends;
+        for (int q = 0; q < QUERIES; ++q) {
+            starts.push_back(centers[pick(rng)].id);
+            ends.push_back(centers[pick(rng)].id);
+        }
+        
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; ++q) shortestPath(starts[q], ends[q]);
+        report("dijkstra", QUERIES, t0);
+        
+        // The first overlay query pays for partitioning and every district's cells
+        t0 = chrono::steady_clock::now();
+        overlayPath(starts[0], ends[0]);
+        report("overlay_build", 1, t0);
+        
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; ++q) overlayPath(starts[q], ends[q]);
+        report("overlay_query", QUERIES, t0);
+        
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; ++q) bfsOrder(starts[q]);
+        report("bfs", QUERIES, t0);
+        
+        t0 = chrono::steady_clock::now();
+        minimumSpanningTree(starts[0]);
+        report("mst", 1, t0);
+        
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < QUERIES; ++q) nearestWithCapacity(starts[q], 500);
+        report("emergency", QUERIES, t0);
+        
+        if (centers.size() <= FLOYD_LIMIT) {
+            t0 = chrono::steady_clock::now();
+            allPairsShortestPaths();
+            report("floyd_warshall", 1, t0);
+        } else {
+            cout << nodes << "," << edges << ",floyd_warshall,0,skipped,skipped\n";
+        }
+    }
+    dataDirectory.clear();
+}
+
 // Read health centers from CSV
 void readHealthCenters() {
-    ifstream file("health_centers.csv");
+    ifstream file(dataPath("health_centers.csv"));
     if (!file.is_open()) {
-        ofstream createFile("health_centers.csv");
+        ofstream createFile(dataPath("health_centers.csv"));
         createFile << "ID,Name,District,Latitude,Longitude,Capacity\n";
         createFile.close();
         return;
@@ -183,6 +1381,8 @@ void readHealthCenters() {
             getline(ss, cap);
             if (!isValidNumber(cap)) continue;
             hc.capacity = stoi(cap);
+            if (hc.id < 0) continue;
+            reserveNodeSlot(hc.id);
             centers.push_back(hc);
         } catch (...) {
             cout << "Error parsing line: " << line << "\n";
@@ -193,7 +1393,7 @@ void readHealthCenters() {
 
 // Save health centers to CSV
 void saveHealthCenters() {
-    ofstream file("health_centers.csv");
+    ofstream file(dataPath("health_centers.csv"));
     file << "ID,Name,District,Latitude,Longitude,Capacity\n";
     for (const auto& hc : centers) {
         file << hc.id << "," << hc.name << "," << hc.district << ","
@@ -202,64 +1402,193 @@ void saveHealthCenters() {
     file.close();
 }
 
-// Read connections from CSV
+// Read connections from CSV, then replay edits journaled since the last save
 void readConnections() {
-    ifstream file("connections.csv");
+    ifstream file(dataPath("connections.csv"));
     if (!file.is_open()) {
-        ofstream createFile("connections.csv");
-        createFile << "FromID,ToID,DistanceKM,TimeMinutes,Description\n";
+        ofstream createFile(dataPath("connections.csv"));
+        createFile << "FromID,ToID,DistanceKM,TimeMinutes,ThroughputPerHour,Description\n";
         createFile.close();
+        replayJournal();
         return;
     }
     
     string line;
-    getline(file, line); // Skip header
+    getline(file, line);
+    // Files written before throughput existed have no rating column
+    bool hasThroughput = line.find("Throughput") != string::npos;
     while (getline(file, line)) {
         try {
             stringstream ss(line);
-            Connection c;
-            string from, to, dist, time;
+            Road r;
+            string from, to, dist, time, throughput;
             getline(ss, from, ',');
             if (!isValidNumber(from)) continue;
-            int fromID = stoi(from);
+            r.from = stoi(from);
             getline(ss, to, ',');
             if (!isValidNumber(to)) continue;
-            c.to = stoi(to);
+            r.to = stoi(to);
             getline(ss, dist, ',');
-            if (!isValidFloat(dist)) continue;
-            c.distance = stof(dist);
+            if (!isValidFloat(dist) || stof(dist) < 0) continue;
+            r.distance = stof(dist);
             getline(ss, time, ',');
             if (!isValidNumber(time)) continue;
-            c.time = stoi(time);
-            getline(ss, c.description);
-            trim(c.description);
-            adjList[fromID].push_back(c);
-            // Add reverse connection for undirected graph
-            Connection reverse = {fromID, c.distance, c.time, c.description};
-            adjList[c.to].push_back(reverse);
+            r.time = stoi(time);
+            r.throughput = UNLIMITED_THROUGHPUT;
+            if (hasThroughput) {
+                getline(ss, throughput, ',');
+                if (!isValidNumber(throughput)) continue;
+                r.throughput = stoi(throughput);
+            }
+            getline(ss, r.description);
+            trim(r.description);
+            r.removed = false;
+            addRoad(r);
         } catch (...) {
             cout << "Error parsing line: " << line << "\n";
         }
     }
     file.close();
+    replayJournal();
 }
 
-// Save connections to CSV
+// Save connections to CSV in one linear pass over the road store, and clear the journal
 void saveConnections() {
-    ofstream file("connections.csv");
-    file << "FromID,ToID,DistanceKM,TimeMinutes,Description\n";
-    set<pair<int, int>> added; // To avoid duplicate edges
-    for (int i = 0; i < MAX; ++i) {
-        for (const auto& c : adjList[i]) {
-            pair<int, int> edge = {min(i, c.to), max(i, c.to)};
-            if (added.find(edge) == added.end()) {
-                file << i << "," << c.to << "," << fixed << setprecision(2) << c.distance
-                     << "," << c.time << "," << c.description << "\n";
-                added.insert(edge);
+    // Drop removed roads and renumber the adjacency entries that point at survivors
+    vector<int> renumber(roads.size(), -1);
+    size_t live = 0;
+    for (size_t i = 0; i < roads.size(); ++i) {
+        if (roads[i].removed) continue;
+        renumber[i] = live;
+        if (live != i) roads[live] = move(roads[i]);
+        ++live;
+    }
+    roads.resize(live);
+    for (auto& list : adjList) {
+        for (auto& c : list) c.road = renumber[c.road];
+    }
+    
+    ofstream file(dataPath("connections.csv"));
+    file << "FromID,ToID,DistanceKM,TimeMinutes,ThroughputPerHour,Description\n";
+    file << fixed << setprecision(2);
+    for (const auto& r : roads) {
+        file << r.from << "," << r.to << "," << r.distance << "," << r.time << ","
+             << r.throughput << "," << r.description << "\n";
+    }
+    file.close();
+    
+    ofstream journal(dataPath("connections.journal"), ios::trunc);
+    journalEntries = 0;
+    saveRoadProfiles();
+}
+
+// Store a road once and generate both traversal directions
+int addRoad(const Road& r) {
+    reserveNodeSlot(max(r.from, r.to));
+    int index = roads.size();
+    roads.push_back(r);
+    adjList[r.from].push_back({r.to, r.distance, toMetres(r.distance), r.time, r.throughput, index, r.profile});
+    adjList[r.to].push_back({r.from, r.distance, toMetres(r.distance), r.time, r.throughput, index, r.profile});
+    return index;
+}
+
+// Copy a road's edited weights into both traversal directions
+void updateRoad(int r) {
+    const Road& road = roads[r];
+    for (int end : {road.from, road.to}) {
+        for (auto& c : adjList[end]) {
+            if (c.road == r) {
+                c.distance = road.distance;
+                c.metres = toMetres(road.distance);
+                c.time = road.time;
+                c.throughput = road.throughput;
+                c.profile = road.profile;
             }
         }
     }
-    file.close();
+}
+
+// Tombstone a road and drop both traversal directions; the slot is reclaimed on the next save
+void deleteRoad(int r) {
+    roads[r].removed = true;
+    for (int end : {roads[r].from, roads[r].to}) {
+        adjList[end].erase(
+            remove_if(adjList[end].begin(), adjList[end].end(), [r](const Connection& c) { return c.road == r; }),
+            adjList[end].end()
+        );
+    }
+}
+
+// Road index between a and b, or -1
+int findRoad(int a, int b) {
+    for (const auto& c : adjList[a]) {
+        if (c.to == b) return c.road;
+    }
+    return -1;
+}
+
+// Record a single road edit by appending to the journal instead of rewriting connections.csv
+void appendJournal(char op, const Road& r) {
+    ofstream journal(dataPath("connections.journal"), ios::app);
+    journal << op << "," << r.from << "," << r.to;
+    if (op != 'D') {
+        journal << "," << fixed << setprecision(2) << r.distance << "," << r.time << ","
+                << r.throughput << "," << r.description;
+    }
+    journal << "\n";
+    journal.close();
+    
+    if (++journalEntries >= JOURNAL_COMPACT_THRESHOLD) saveConnections();
+}
+
+// Apply journaled adds (A), updates (U) and deletes (D) on top of connections.csv
+void replayJournal() {
+    ifstream journal(dataPath("connections.journal"));
+    if (!journal.is_open()) return;
+    
+    string line;
+    while (getline(journal, line)) {
+        try {
+            stringstream ss(line);
+            string op, from, to, dist, time, throughput;
+            getline(ss, op, ',');
+            getline(ss, from, ',');
+            getline(ss, to, ',');
+            if (op.size() != 1 || !isValidNumber(from) || !isValidNumber(to)) continue;
+            
+            Road r;
+            r.from = stoi(from);
+            r.to = stoi(to);
+            r.removed = false;
+            int existing = findRoad(r.from, r.to);
+            
+            if (op[0] == 'D') {
+                if (existing != -1) deleteRoad(existing);
+            } else {
+                getline(ss, dist, ',');
+                getline(ss, time, ',');
+                getline(ss, throughput, ',');
+                if (!isValidFloat(dist) || stof(dist) < 0 || !isValidNumber(time) || !isValidNumber(throughput)) continue;
+                r.distance = stof(dist);
+                r.time = stoi(time);
+                r.throughput = stoi(throughput);
+                getline(ss, r.description);
+                if (existing == -1) {
+                    addRoad(r);
+                } else {
+                    r.from = roads[existing].from;
+                    r.to = roads[existing].to;
+                    r.profile = roads[existing].profile;
+                    roads[existing] = r;
+                    updateRoad(existing);
+                }
+            }
+            ++journalEntries;
+        } catch (...) {
+            cout << "Error parsing journal line: " << line << "\n";
+        }
+    }
+    journal.close();
 }
 
 // Add a new health center
@@ -274,6 +1603,10 @@ void addHealthCenter() {
         return;
     }
     hc.id = stoi(input);
+    if (hc.id < 0) {
+        cout << "Error: ID must not be negative.\n";
+        return;
+    }
     
     if (centerExists(hc.id)) {
         cout << "Error: Health Center ID already exists.\n";
@@ -306,8 +1639,10 @@ void addHealthCenter() {
     }
     hc.capacity = stoi(input);
     
+    reserveNodeSlot(hc.id);
     centers.push_back(hc);
     saveHealthCenters();
+    invalidateOverlay();
     cout << "Health Center added successfully.\n";
 }
 
@@ -355,6 +1690,7 @@ void editHealthCenter() {
     it->capacity = stoi(input);
     
     saveHealthCenters();
+    invalidateOverlay();
     cout << "Health Center updated successfully.\n";
 }
 
@@ -403,22 +1739,25 @@ void removeHealthCenter() {
     }
     
     centers.erase(it);
-    adjList[id].clear();
-    for (int i = 0; i < MAX; ++i) {
-        adjList[i].erase(
-            remove_if(adjList[i].begin(), adjList[i].end(), [id](const Connection& c) { return c.to == id; }),
-            adjList[i].end()
-        );
+    while (!adjList[id].empty()) {
+        deleteRoad(adjList[id].back().road);
     }
     
     saveHealthCenters();
+    invalidateOverlay();
     saveConnections();
+    
+    // Many roads changed at once, and the center may itself have been a hub
+    hubTrees.erase(remove_if(hubTrees.begin(), hubTrees.end(), [id](const HubTree& t) { return t.source == id; }),
+                   hubTrees.end());
+    saveHubs();
+    rebuildHubTrees();
     cout << "Health Center and related connections removed successfully.\n";
 }
 
 // Add a new connection
 void addConnection() {
-    Connection c;
+    Road c;
     string input;
     
     cout << "Enter From Health Center ID: ";
@@ -448,17 +1787,15 @@ void addConnection() {
     }
     
     // Check if connection exists
-    for (const auto& conn : adjList[fromID]) {
-        if (conn.to == c.to) {
-            cout << "Error: Connection already exists.\n";
-            return;
-        }
+    if (findRoad(fromID, c.to) != -1) {
+        cout << "Error: Connection already exists.\n";
+        return;
     }
     
     cout << "Enter Distance (km): ";
     getline(cin, input);
-    if (!isValidFloat(input)) {
-        cout << "Error: Distance must be a valid number.\n";
+    if (!isValidFloat(input) || stof(input) < 0) {
+        cout << "Error: Distance must be a non-negative number.\n";
         return;
     }
     c.distance = stof(input);
@@ -471,15 +1808,24 @@ void addConnection() {
     }
     c.time = stoi(input);
     
+    cout << "Enter Throughput (patients/hour, -1 for no limit): ";
+    getline(cin, input);
+    if (!isValidNumber(input) || stoi(input) < UNLIMITED_THROUGHPUT) {
+        cout << "Error: Throughput must be a valid number.\n";
+        return;
+    }
+    c.throughput = stoi(input);
+    
     cout << "Enter Description: ";
     getline(cin, c.description);
     trim(c.description);
+    c.from = fromID;
+    c.removed = false;
     
-    adjList[fromID].push_back(c);
-    Connection reverse = {fromID, c.distance, c.time, c.description};
-    adjList[c.to].push_back(reverse);
-    
-    saveConnections();
+    addRoad(c);
+    appendJournal('A', c);
+    repairHubTrees(fromID, c.to);
+    overlayRoadChanged(fromID, c.to);
     cout << "Connection added successfully.\n";
 }
 
@@ -507,17 +1853,19 @@ void editConnection() {
         return;
     }
     
-    auto it = find_if(adjList[fromID].begin(), adjList[fromID].end(),
-        [toID](const Connection& c) { return c.to == toID; });
-    if (it == adjList[fromID].end()) {
+    int r = findRoad(fromID, toID);
+    if (r == -1) {
         cout << "Error: Connection not found.\n";
         return;
     }
+    // Edit a copy so a rejected value leaves the stored road untouched
+    Road edited = roads[r];
+    Road* it = &edited;
     
     cout << "Enter new Distance (km, current: " << it->distance << "): ";
     getline(cin, input);
-    if (!isValidFloat(input)) {
-        cout << "Error: Distance must be a valid number.\n";
+    if (!isValidFloat(input) || stof(input) < 0) {
+        cout << "Error: Distance must be a non-negative number.\n";
         return;
     }
     it->distance = stof(input);
@@ -529,21 +1877,29 @@ void editConnection() {
         return;
     }
     it->time = stoi(input);
+    // The road's time profile scales the base time, so a new time can make it non-FIFO
+    if (it->profile != -1 && !profileIsFifo(it->profile, it->time)) {
+        cout << "Error: With this time the road's profile drops too steeply; a later departure would arrive earlier.\n";
+        return;
+    }
+    
+    cout << "Enter new Throughput (patients/hour, -1 for no limit, current: " << it->throughput << "): ";
+    getline(cin, input);
+    if (!isValidNumber(input) || stoi(input) < UNLIMITED_THROUGHPUT) {
+        cout << "Error: Throughput must be a valid number.\n";
+        return;
+    }
+    it->throughput = stoi(input);
     
     cout << "Enter new Description (current: " << it->description << "): ";
     getline(cin, it->description);
     trim(it->description);
     
-    // Update reverse connection
-    auto reverseIt = find_if(adjList[toID].begin(), adjList[toID].end(),
-        [fromID](const Connection& c) { return c.to == fromID; });
-    if (reverseIt != adjList[toID].end()) {
-        reverseIt->distance = it->distance;
-        reverseIt->time = it->time;
-        reverseIt->description = it->description;
-    }
-    
-    saveConnections();
+    roads[r] = edited;
+    updateRoad(r);
+    appendJournal('U', edited);
+    repairHubTrees(fromID, toID);
+    overlayRoadChanged(fromID, toID);
     cout << "Connection updated successfully.\n";
 }
 
@@ -555,24 +1911,20 @@ void viewConnections() {
          << setw(10) << "ToID"
          << setw(15) << "Distance(km)"
          << setw(15) << "Time(min)"
+         << setw(15) << "Throughput/h"
          << setw(20) << "Description" << "\n";
-    cout << string(70, '-') << "\n";
+    cout << string(85, '-') << "\n";
     
-    set<pair<int, int>> added;
-    for (int i = 0; i < MAX; ++i) {
-        for (const auto& c : adjList[i]) {
-            pair<int, int> edge = {min(i, c.to), max(i, c.to)};
-            if (added.find(edge) == added.end()) {
-                cout << left
-                     << setw(10) << i
-                     << setw(10) << c.to
-                     << setw(15) << fixed << setprecision(2) << c.distance
-                     << setw(15) << c.time
-                     << setw(20) << c.description << "\n";
-                added.insert(edge);
-                hasConnections = true;
-            }
-        }
+    for (const auto& r : roads) {
+        if (r.removed) continue;
+        cout << left
+             << setw(10) << r.from
+             << setw(10) << r.to
+             << setw(15) << fixed << setprecision(2) << r.distance
+             << setw(15) << r.time
+             << setw(15) << (r.throughput == UNLIMITED_THROUGHPUT ? string("Unlimited") : to_string(r.throughput))
+             << setw(20) << r.description << "\n";
+        hasConnections = true;
     }
     
     if (!hasConnections) {
@@ -604,69 +1956,130 @@ void removeConnection() {
         return;
     }
     
-    auto it = find_if(adjList[fromID].begin(), adjList[fromID].end(),
-        [toID](const Connection& c) { return c.to == toID; });
-    if (it == adjList[fromID].end()) {
+    int r = findRoad(fromID, toID);
+    if (r == -1) {
         cout << "Error: Connection not found.\n";
         return;
     }
     
-    adjList[fromID].erase(it);
-    
-    auto reverseIt = find_if(adjList[toID].begin(), adjList[toID].end(),
-        [fromID](const Connection& c) { return c.to == fromID; });
-    if (reverseIt != adjList[toID].end()) {
-        adjList[toID].erase(reverseIt);
-    }
-    
-    saveConnections();
+    deleteRoad(r);
+    appendJournal('D', roads[r]);
+    repairHubTrees(fromID, toID);
+    overlayRoadChanged(fromID, toID);
     cout << "Connection removed successfully.\n";
 }
 
-// Display relationships table and save to CSV
+// Display relationships table and save to CSV in one O(V+E) pass, paginating the console output
 void viewRelationships() {
-    ofstream file("relationship_table.csv");
-    file << "Health Center ID,Name,Connected Centers,Descriptions\n";
+    string input;
+    cout << "Enter rows per page (0 for all): ";
+    getline(cin, input);
+    if (!isValidNumber(input) || stoi(input) < 0) {
+        cout << "Error: Page size must be a non-negative number.\n";
+        return;
+    }
+    size_t pageSize = stoi(input);
     
-    cout << "\n" << left
-         << setw(15) << "ID"
-         << setw(25) << "Name"
-         << setw(25) << "Connected Centers"
-         << setw(30) << "Descriptions" << "\n";
-    cout << string(95, '-') << "\n";
+    vector<char> exists(adjList.size(), 0);
+    for (const auto& hc : centers) exists[hc.id] = 1;
     
+    ofstream file("relationship_table.csv");
+    BufferedWriter csv(file);
+    BufferedWriter console(cout);
+    csv.append("Health Center ID,Name,Connected Centers,Descriptions\n");
+    
+    string header;
+    header += "\n";
+    appendPadded(header, "ID", 15);
+    appendPadded(header, "Name", 25);
+    appendPadded(header, "Connected Centers", 25);
+    appendPadded(header, "Descriptions", 30);
+    header += "\n" + string(95, '-') + "\n";
+    console.append(header);
+    
+    bool consoleActive = true;
+    size_t rows = 0;
+    string connected, descriptions, row;
     for (const auto& hc : centers) {
-        string connected, descriptions;
+        connected.clear();
+        descriptions.clear();
         for (const auto& c : adjList[hc.id]) {
-            auto it = find_if(centers.begin(), centers.end(),
-                [c](const HealthCenter& center) { return center.id == c.to; });
-            if (it != centers.end()) {
-                connected += to_string(c.to) + ";";
-                descriptions += c.description + ";";
+            if (!exists[c.to]) continue;
+            if (!connected.empty()) {
+                connected += ';';
+                descriptions += ';';
             }
+            connected += to_string(c.to);
+            descriptions += roads[c.road].description;
         }
-        
-        if (!connected.empty()) {
-            connected = connected.substr(0, connected.length() - 1);
-            descriptions = descriptions.substr(0, descriptions.length() - 1);
-        } else {
+        if (connected.empty()) {
             connected = "None";
             descriptions = "None";
         }
         
-        cout << left
-             << setw(15) << hc.id
-             << setw(25) << hc.name
-             << setw(25) << connected
-             << setw(30) << descriptions << "\n";
+        string id = to_string(hc.id);
+        row.clear();
+        row.append(id).append(",").append(hc.name).append(",").append(connected).append(",").append(descriptions).append("\n");
+        csv.append(row);
         
-        file << hc.id << "," << hc.name << "," << connected << "," << descriptions << "\n";
+        if (!consoleActive) continue;
+        row.clear();
+        appendPadded(row, id, 15);
+        appendPadded(row, hc.name, 25);
+        appendPadded(row, connected, 25);
+        appendPadded(row, descriptions, 30);
+        row += "\n";
+        console.append(row);
+        
+        if (pageSize > 0 && ++rows % pageSize == 0 && rows < centers.size()) {
+            console.flush();
+            cout << "-- " << rows << "/" << centers.size() << " shown, Enter for more, q to stop --";
+            getline(cin, input);
+            if (input == "q" || input == "Q") consoleActive = false;
+        }
     }
     
+    console.flush();
+    csv.flush();
     file.close();
     cout << "Relationships exported to relationship_table.csv successfully.\n";
 }
 
+// Walk predecessors back from end and return the path start -> end
+vector<int> tracePath(const vector<int>& prev, int end) {
+    vector<int> path;
+    for (int at = end; at != -1; at = prev[at]) {
+        path.push_back(at);
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+void printPath(const vector<int>& path) {
+    cout << "Path: ";
+    for (size_t i = 0; i < path.size(); ++i) {
+        cout << path[i];
+        if (i < path.size() - 1) cout << " -> ";
+    }
+    cout << "\n";
+}
+
+// Shortest path between two existing centers
+PathResult shortestPath(int start, int end) {
+    return weightMode == WeightMode::Fixed ? shortestPath<FixedWeight>(start, end) : shortestPath<FloatWeight>(start, end);
+}
+
+template <typename W>
+PathResult shortestPath(int start, int end) {
+    vector<typename W::Type> dist;
+    vector<int> prev;
+    shortestPaths<W>(start, dist, prev);
+    
+    PathResult result = {dist[end] != W::infinity(), W::km(dist[end]), {}};
+    if (result.found) result.path = tracePath(prev, end);
+    return result;
+}
+
 // Dijkstra's algorithm for shortest path
 void dijkstra(int start, int end) {
     if (!centerExists(start) || !centerExists(end)) {
@@ -674,46 +2087,31 @@ void dijkstra(int start, int end) {
         return;
     }
     
-    vector<float> dist(MAX, INF);
-    vector<int> prev(MAX, -1);
-    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
-    
-    dist[start] = 0;
-    pq.push({0, start});
-    
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        float d = pq.top().first;
-        pq.pop();
-        
-        if (d > dist[u]) continue;
-        
-        for (const auto& c : adjList[u]) {
-            if (dist[u] + c.distance < dist[c.to]) {
-                dist[c.to] = dist[u] + c.distance;
-                prev[c.to] = u;
-                pq.push({dist[c.to], c.to});
-            }
-        }
-    }
-    
-    if (dist[end] == INF) {
+    PathResult result = shortestPath(start, end);
+    if (!result.found) {
         cout << "No path exists between " << start << " and " << end << ".\n";
         return;
     }
     
-    cout << "Shortest distance from " << start << " to " << end << ": " << fixed << setprecision(2) << dist[end] << " km\n";
-    cout << "Path: ";
-    vector<int> path;
-    for (int at = end; at != -1; at = prev[at]) {
-        path.push_back(at);
-    }
-    reverse(path.begin(), path.end());
-    for (size_t i = 0; i < path.size(); ++i) {
-        cout << path[i];
-        if (i < path.size() - 1) cout << " -> ";
+    cout << "Shortest distance from " << start << " to " << end << ": " << fixed << setprecision(2) << result.distance << " km\n";
+    printPath(result.path);
+}
+
+// Breadth-first visiting order from an existing center
+vector<int> bfsOrder(int start) {
+    vector<bool> visited(adjList.size(), false);
+    vector<int> order = {start};
+    visited[start] = true;
+    
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (const auto& c : adjList[order[i]]) {
+            if (!visited[c.to]) {
+                visited[c.to] = true;
+                order.push_back(c.to);
+            }
+        }
     }
-    cout << "\n";
+    return order;
 }
 
 // BFS traversal
@@ -723,32 +2121,17 @@ void bfs(int start) {
         return;
     }
     
-    vector<bool> visited(MAX, false);
-    queue<int> q;
-    
-    visited[start] = true;
-    q.push(start);
-    
     cout << "BFS Traversal starting from " << start << ": ";
-    while (!q.empty()) {
-        int u = q.front();
-        q.pop();
+    for (int u : bfsOrder(start)) {
         cout << u << " ";
-        
-        for (const auto& c : adjList[u]) {
-            if (!visited[c.to]) {
-                visited[c.to] = true;
-                q.push(c.to);
-            }
-        }
     }
     cout << "\n";
 }
 
 // Cycle detection using DFS
 bool detectCycle() {
-    vector<bool> visited(MAX, false);
-    vector<bool> recStack(MAX, false);
+    vector<bool> visited(adjList.size(), false);
+    vector<bool> recStack(adjList.size(), false);
     
     for (const auto& hc : centers) {
         if (!visited[hc.id]) {
@@ -778,102 +2161,494 @@ bool detectCycleDFS(int v, vector<bool>& visited, vector<bool>& recStack, int pa
     return false;
 }
 
-// Floyd-Warshall algorithm
-void floydWarshall() {
-    int maxID = 0;
-    for (const auto& hc : centers) {
-        maxID = max(maxID, hc.id);
+// Iterative Tarjan: articulation points and bridges with an explicit stack instead of recursion
+ResilienceReport findCriticalPoints(const Graph& adj, const vector<int>& nodes) {
+    struct Frame {
+        int v;
+        int parent;
+        size_t next;        // Next adjacency slot to explore
+        bool skippedParent; // Only one road back to the parent is the tree edge
+        int children;
+    };
+    
+    ResilienceReport report;
+    vector<int> disc(adj.size(), -1);
+    vector<int> low(adj.size(), 0);
+    vector<char> isCut(adj.size(), 0);
+    vector<Frame> stack;
+    int timer = 0;
+    
+    for (int root : nodes) {
+        if (disc[root] != -1) continue;
+        disc[root] = low[root] = timer++;
+        stack.push_back({root, -1, 0, false, 0});
+        
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            if (f.next < adj[f.v].size()) {
+                int w = adj[f.v][f.next++].to;
+                if (w == f.parent && !f.skippedParent) {
+                    f.skippedParent = true;
+                } else if (disc[w] == -1) {
+                    f.children++;
+                    disc[w] = low[w] = timer++;
+                    stack.push_back({w, f.v, 0, false, 0});
+                } else {
+                    low[f.v] = min(low[f.v], disc[w]);
+                }
+                continue;
+            }
+            
+            Frame done = f;
+            stack.pop_back();
+            if (stack.empty()) {
+                // The DFS root is a cut point only if it has several tree children
+                if (done.children > 1) isCut[done.v] = 1;
+                continue;
+            }
+            
+            Frame& up = stack.back();
+            low[up.v] = min(low[up.v], low[done.v]);
+            if (low[done.v] > disc[up.v]) {
+                report.bridges.emplace_back(up.v, done.v);
+            }
+            if (up.parent != -1 && low[done.v] >= disc[up.v]) {
+                isCut[up.v] = 1;
+            }
+        }
+    }
+    
+    for (int v : nodes) {
+        if (isCut[v]) report.articulationPoints.push_back(v);
+    }
+    return report;
+}
+
+// Display centers and roads whose loss splits the network, and export to CSV
+void networkResilience() {
+    if (centers.empty()) {
+        cout << "No health centers available.\n";
+        return;
     }
     
-    vector<vector<float>> dist(maxID + 1, vector<float>(maxID + 1, INF));
-    vector<vector<int>> next(maxID + 1, vector<int>(maxID + 1, -1));
+    vector<int> nodes;
+    for (const auto& hc : centers) nodes.push_back(hc.id);
+    ResilienceReport report = findCriticalPoints(adjList, nodes);
     
-    for (int i = 0; i <= maxID; ++i) {
-        dist[i][i] = 0;
+    ofstream file("network_resilience.csv");
+    file << "Type,FromID,ToID,Description\n";
+    
+    cout << "\nCritical health centers (articulation points):\n";
+    if (report.articulationPoints.empty()) cout << "None\n";
+    for (int id : report.articulationPoints) {
+        auto it = find_if(centers.begin(), centers.end(), [id](const HealthCenter& hc) { return hc.id == id; });
+        cout << id << " - " << it->name << " (" << it->district << ")\n";
+        file << "ArticulationPoint," << id << ",," << it->name << "\n";
     }
     
-    for (int u = 0; u <= maxID; ++u) {
-        for (const auto& c : adjList[u]) {
-            dist[u][c.to] = c.distance;
-            next[u][c.to] = c.to;
+    cout << "\nCritical roads (bridges):\n";
+    if (report.bridges.empty()) cout << "None\n";
+    for (const auto& b : report.bridges) {
+        string description = roads[findRoad(b.first, b.second)].description;
+        cout << b.first << " - " << b.second << " (" << description << ")\n";
+        file << "Bridge," << b.first << "," << b.second << "," << description << "\n";
+    }
+    
+    file.close();
+    cout << "Resilience analysis exported to network_resilience.csv successfully.\n";
+}
+
+// Max patients per hour from district A to district B, with the bottlenecks that limit it
+void districtTransferCapacity() {
+    string from, to;
+    cout << "Enter source District: ";
+    getline(cin, from);
+    trim(from);
+    cout << "Enter destination District: ";
+    getline(cin, to);
+    trim(to);
+    if (from == to) {
+        cout << "Error: Districts must differ.\n";
+        return;
+    }
+    
+    // Each center i is split into in-node 2i and out-node 2i+1 so its capacity bounds the flow through it
+    vector<int> indexOf(adjList.size(), -1);
+    for (size_t i = 0; i < centers.size(); ++i) indexOf[centers[i].id] = i;
+    int source = 2 * centers.size();
+    int sink = source + 1;
+    const int64_t UNBOUNDED = numeric_limits<int64_t>::max() / 4;
+    
+    MaxFlow flow(sink + 1);
+    vector<int> centerArc(centers.size());
+    vector<pair<int, pair<int, int>>> roadArcs; // arc, (from, to)
+    bool hasFrom = false, hasTo = false;
+    
+    for (size_t i = 0; i < centers.size(); ++i) {
+        const HealthCenter& hc = centers[i];
+        centerArc[i] = flow.addArc(2 * i, 2 * i + 1, max(0, hc.capacity));
+        if (hc.district == from) {
+            flow.addArc(source, 2 * i, UNBOUNDED);
+            hasFrom = true;
+        }
+        if (hc.district == to) {
+            flow.addArc(2 * i + 1, sink, UNBOUNDED);
+            hasTo = true;
+        }
+        for (const auto& c : adjList[hc.id]) {
+            if (indexOf[c.to] == -1) continue;
+            int64_t limit = c.throughput == UNLIMITED_THROUGHPUT ? UNBOUNDED : c.throughput;
+            roadArcs.push_back({flow.addArc(2 * i + 1, 2 * indexOf[c.to], limit), {hc.id, c.to}});
+        }
+    }
+    
+    if (!hasFrom || !hasTo) {
+        cout << "Error: One or both districts have no health centers.\n";
+        return;
+    }
+    
+    int64_t total = flow.solve(source, sink);
+    cout << "Maximum transfer from " << from << " to " << to << ": " << total << " patients/hour\n";
+    if (total == 0) return;
+    
+    // Saturated arcs crossing the minimum cut are what limit the transfer
+    cout << "Bottlenecks (minimum cut):\n";
+    for (size_t i = 0; i < centers.size(); ++i) {
+        if (flow.sourceSide(2 * i) && !flow.sourceSide(2 * i + 1)) {
+            cout << "  Center " << centers[i].id << " (" << centers[i].name << ") at capacity "
+                 << flow.capacityOf(centerArc[i]) << "\n";
+        }
+    }
+    for (const auto& r : roadArcs) {
+        int u = indexOf[r.second.first], v = indexOf[r.second.second];
+        if (flow.sourceSide(2 * u + 1) && !flow.sourceSide(2 * v)) {
+            cout << "  Road " << r.second.first << " -> " << r.second.second << " at throughput "
+                 << flow.capacityOf(r.first) << "\n";
+        }
+    }
+}
+
+// Brandes dependency accumulation from the given sources; each thread sums into its own array
+vector<double> betweennessCentrality(const Graph& adj, const vector<int>& nodes, const vector<int>& sources, unsigned threads) {
+    if (weightMode == WeightMode::Fixed) return betweennessCentrality<FixedWeight>(adj, nodes, sources, threads);
+    return betweennessCentrality<FloatWeight>(adj, nodes, sources, threads);
+}
+
+// Equal-length path counting is exact with fixed weights; with floats, ties can be missed by rounding
+template <typename W>
+vector<double> betweennessCentrality(const Graph& adj, const vector<int>& nodes, const vector<int>& sources, unsigned threads) {
+    typedef typename W::Type Weight;
+    threads = max(1u, min<unsigned>(threads, sources.size()));
+    vector<vector<double>> partial(threads, vector<double>(adj.size(), 0.0));
+    
+    auto work = [&](unsigned w) {
+        vector<Weight> dist(adj.size(), W::infinity());
+        vector<double> sigma(adj.size(), 0.0);
+        vector<double> delta(adj.size(), 0.0);
+        vector<int> rank(adj.size(), -1);  // settle position, -1 while unsettled
+        vector<int> order;
+        QuaternaryHeap<Weight> pq(adj.size());
+        vector<double>& bc = partial[w];
+        
+        for (size_t i = w; i < sources.size(); i += threads) {
+            int s = sources[i];
+            dist[s] = 0;
+            sigma[s] = 1;
+            pq.push(s, 0);
+            
+            // Forward pass: settle order and shortest-path counts
+            while (!pq.empty()) {
+                int u = pq.pop();
+                rank[u] = order.size();
+                order.push_back(u);
+                for (const auto& c : adj[u]) {
+                    Weight candidate = dist[u] + W::of(c);
+                    if (candidate < dist[c.to]) {
+                        dist[c.to] = candidate;
+                        sigma[c.to] = sigma[u];
+                        pq.push(c.to, candidate);
+                    } else if (candidate == dist[c.to] && rank[c.to] < 0) {
+                        // Zero-length roads tie with already settled nodes; their counts are final
+                        sigma[c.to] += sigma[u];
+                    }
+                }
+            }
+            
+            // Backward pass: predecessors are re-derived from the adjacency instead of stored lists,
+            // and must have settled before v so zero-length roads are not counted both ways
+            for (size_t k = order.size(); k-- > 0;) {
+                int v = order[k];
+                for (const auto& c : adj[v]) {
+                    if (rank[c.to] >= 0 && rank[c.to] < rank[v] && dist[c.to] + W::of(c) == dist[v]) {
+                        delta[c.to] += sigma[c.to] / sigma[v] * (1.0 + delta[v]);
+                    }
+                }
+                if (v != s) bc[v] += delta[v];
+            }
+            
+            for (int v : order) {
+                dist[v] = W::infinity();
+                sigma[v] = 0;
+                delta[v] = 0;
+                rank[v] = -1;
+            }
+            order.clear();
+        }
+    };
+    
+    if (threads == 1) {
+        work(0);
+    } else {
+        vector<thread> pool;
+        for (unsigned w = 0; w < threads; ++w) pool.emplace_back(work, w);
+        for (auto& t : pool) t.join();
+    }
+    
+    vector<double> total(adj.size(), 0.0);
+    for (const auto& bc : partial) {
+        for (int v : nodes) total[v] += bc[v];
+    }
+    return total;
+}
+
+// Rank centers by betweenness, exactly or from a sample of sources, and export to CSV
+void betweennessRanking() {
+    if (centers.size() < 3) {
+        cout << "At least three health centers are needed.\n";
+        return;
+    }
+    
+    string input;
+    cout << "Enter error bound epsilon (0 for exact): ";
+    getline(cin, input);
+    if (!isValidFloat(input) || stof(input) < 0 || stof(input) >= 1) {
+        cout << "Error: Epsilon must be in [0, 1).\n";
+        return;
+    }
+    double epsilon = stof(input);
+    
+    vector<int> nodes;
+    for (const auto& hc : centers) nodes.push_back(hc.id);
+    size_t n = nodes.size();
+    
+    // Hoeffding plus a union bound over all centers: every normalized score is within
+    // epsilon of the exact one with probability at least 1 - delta
+    const double confidenceDelta = 0.1;
+    size_t samples = n;
+    if (epsilon > 0) {
+        double scaled = epsilon * (n - 1) / n;
+        samples = min(n, static_cast<size_t>(ceil(log(2.0 * n / confidenceDelta) / (2 * scaled * scaled))));
+    }
+    
+    vector<int> sources = nodes;
+    if (samples < n) {
+        mt19937 rng(random_device{}());
+        shuffle(sources.begin(), sources.end(), rng);
+        sources.resize(samples);
+    }
+    
+    auto t0 = chrono::steady_clock::now();
+    vector<double> bc = betweennessCentrality(adjList, nodes, sources, thread::hardware_concurrency());
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    
+    // Undirected paths are seen from both ends; sampled sums are scaled up to all sources
+    double scale = 0.5 * n / sources.size();
+    double pairs = (n - 1) * (n - 2) / 2.0;
+    vector<pair<double, int>> ranked;
+    for (size_t i = 0; i < n; ++i) ranked.emplace_back(bc[nodes[i]] * scale, i);
+    sort(ranked.begin(), ranked.end(), [](const pair<double, int>& a, const pair<double, int>& b) { return a.first > b.first; });
+    
+    ofstream file("betweenness_ranking.csv");
+    file << "Rank,Health Center ID,Name,District,Betweenness,Normalized\n";
+    cout << "\n" << left
+         << setw(6) << "Rank"
+         << setw(10) << "ID"
+         << setw(25) << "Name"
+         << setw(20) << "District"
+         << setw(15) << "Betweenness"
+         << setw(12) << "Normalized" << "\n";
+    cout << string(88, '-') << "\n";
+    
+    for (size_t r = 0; r < ranked.size(); ++r) {
+        const HealthCenter& hc = centers[ranked[r].second];
+        double score = ranked[r].first;
+        file << r + 1 << "," << hc.id << "," << hc.name << "," << hc.district << ","
+             << fixed << setprecision(4) << score << "," << setprecision(6) << score / pairs << "\n";
+        if (r < 10) {
+            cout << left << setw(6) << r + 1 << setw(10) << hc.id << setw(25) << hc.name << setw(20) << hc.district
+                 << setw(15) << fixed << setprecision(2) << score << setw(12) << setprecision(4) << score / pairs << "\n";
+        }
+    }
+    file.close();
+    
+    if (samples < n) {
+        cout << "Approximate ranking from " << samples << " of " << n << " sources (error <= " << epsilon
+             << " with probability " << 1 - confidenceDelta << ")\n";
+    }
+    cout << "Computed in " << fixed << setprecision(1) << ms << " ms\n";
+    cout << "Ranking exported to betweenness_ranking.csv successfully.\n";
+}
+
+// Floyd-Warshall over the centers, indexed by their position in centers rather than by ID
+AllPairsResult allPairsShortestPaths() {
+    return weightMode == WeightMode::Fixed ? allPairsShortestPaths<FixedWeight>() : allPairsShortestPaths<FloatWeight>();
+}
+
+template <typename W>
+AllPairsResult allPairsShortestPaths() {
+    typedef typename W::Type Weight;
+    const Weight inf = W::infinity();
+    size_t n = centers.size();
+    AllPairsResult result;
+    vector<vector<Weight>> dist(n, vector<Weight>(n, inf));
+    result.next.assign(n, vector<int>(n, -1));
+    
+    vector<int> indexOf(adjList.size(), -1);
+    for (size_t i = 0; i < n; ++i) {
+        indexOf[centers[i].id] = i;
+        result.ids.push_back(centers[i].id);
+    }
+    
+    for (size_t i = 0; i < n; ++i) {
+        dist[i][i] = 0;
+        for (const auto& c : adjList[centers[i].id]) {
+            int j = indexOf[c.to];
+            if (j != -1 && W::of(c) < dist[i][j]) {
+                dist[i][j] = W::of(c);
+                result.next[i][j] = j;
+            }
         }
     }
     
-    for (int k = 0; k <= maxID; ++k) {
-        for (int i = 0; i <= maxID; ++i) {
-            for (int j = 0; j <= maxID; ++j) {
-                if (dist[i][k] != INF && dist[k][j] != INF && dist[i][k] + dist[k][j] < dist[i][j]) {
-                    dist[i][j] = dist[i][k] + dist[k][j];
-                    next[i][j] = next[i][k];
+    for (size_t k = 0; k < n; ++k) {
+        const vector<Weight>& viaK = dist[k];
+        for (size_t i = 0; i < n; ++i) {
+            Weight toK = dist[i][k];
+            if (toK == inf) continue;
+            vector<Weight>& row = dist[i];
+            for (size_t j = 0; j < n; ++j) {
+                if (viaK[j] != inf && toK + viaK[j] < row[j]) {
+                    row[j] = toK + viaK[j];
+                    result.next[i][j] = result.next[i][k];
                 }
             }
         }
     }
     
+    result.dist.assign(n, vector<float>(n, INF));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (dist[i][j] != inf) result.dist[i][j] = W::km(dist[i][j]);
+        }
+    }
+    return result;
+}
+
+// Floyd-Warshall algorithm
+void floydWarshall() {
+    AllPairsResult result = allPairsShortestPaths();
+    
     cout << "\nAll-Pairs Shortest Paths (distances in km):\n";
     cout << left << setw(10) << "From\\To";
-    for (const auto& hc : centers) {
-        cout << setw(10) << hc.id;
+    for (int id : result.ids) {
+        cout << setw(10) << id;
     }
-    cout << "\n" << string(10 + centers.size() * 10, '-') << "\n";
+    cout << "\n" << string(10 + result.ids.size() * 10, '-') << "\n";
     
-    for (const auto& hc1 : centers) {
-        cout << left << setw(10) << hc1.id;
-        for (const auto& hc2 : centers) {
-            if (dist[hc1.id][hc2.id] == INF) {
+    for (size_t i = 0; i < result.ids.size(); ++i) {
+        cout << left << setw(10) << result.ids[i];
+        for (size_t j = 0; j < result.ids.size(); ++j) {
+            if (result.dist[i][j] == INF) {
                 cout << setw(10) << "INF";
             } else {
-                cout << setw(10) << fixed << setprecision(2) << dist[hc1.id][hc2.id];
+                cout << setw(10) << fixed << setprecision(2) << result.dist[i][j];
             }
         }
         cout << "\n";
     }
 }
 
-// Prim's algorithm for MST
-void primMST(int start) {
-    if (!centerExists(start)) {
-        cout << "Error: Health Center ID not found.\n";
-        return;
-    }
-    
-    vector<float> key(MAX, INF);
-    vector<int> parent(MAX, -1);
-    vector<bool> inMST(MAX, false);
-    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
+// Prim's minimum spanning tree of the component containing an existing center
+MSTResult minimumSpanningTree(int start) {
+    return weightMode == WeightMode::Fixed ? minimumSpanningTree<FixedWeight>(start) : minimumSpanningTree<FloatWeight>(start);
+}
+
+template <typename W>
+MSTResult minimumSpanningTree(int start) {
+    typedef typename W::Type Weight;
+    vector<Weight> key(adjList.size(), W::infinity());
+    vector<int> parent(adjList.size(), -1);
+    vector<bool> inMST(adjList.size(), false);
+    // Prim's keys are not monotone, so it always uses the 4-ary heap
+    QuaternaryHeap<Weight> pq(adjList.size());
     
     key[start] = 0;
-    pq.push({0, start});
-    
-    float totalWeight = 0;
-    vector<pair<int, int>> edges;
+    pq.push(start, 0);
     
+    MSTResult result = {{}, 0};
+    Weight total = 0;
     while (!pq.empty()) {
-        int u = pq.top().second;
-        pq.pop();
-        
-        if (inMST[u]) continue;
+        int u = pq.pop();
         inMST[u] = true;
         
         if (parent[u] != -1) {
-            totalWeight += key[u];
-            edges.emplace_back(parent[u], u);
+            total += key[u];
+            result.edges.emplace_back(parent[u], u);
         }
         
         for (const auto& c : adjList[u]) {
-            if (!inMST[c.to] && c.distance < key[c.to]) {
-                key[c.to] = c.distance;
+            if (!inMST[c.to] && W::of(c) < key[c.to]) {
+                key[c.to] = W::of(c);
                 parent[c.to] = u;
-                pq.push({key[c.to], c.to});
+                pq.push(c.to, key[c.to]);
             }
         }
     }
+    result.totalWeight = W::km(total);
+    return result;
+}
+
+// Prim's algorithm for MST
+void primMST(int start) {
+    if (!centerExists(start)) {
+        cout << "Error: Health Center ID not found.\n";
+        return;
+    }
     
+    MSTResult result = minimumSpanningTree(start);
     cout << "Minimum Spanning Tree Edges:\n";
-    for (const auto& edge : edges) {
+    for (const auto& edge : result.edges) {
         cout << edge.first << " - " << edge.second << "\n";
     }
-    cout << "Total MST weight: " << fixed << setprecision(2) << totalWeight << " km\n";
+    cout << "Total MST weight: " << fixed << setprecision(2) << result.totalWeight << " km\n";
+}
+
+// Nearest other center with at least minCapacity, from an existing start center
+EmergencyResult nearestWithCapacity(int start, int minCapacity) {
+    if (weightMode == WeightMode::Fixed) return nearestWithCapacity<FixedWeight>(start, minCapacity);
+    return nearestWithCapacity<FloatWeight>(start, minCapacity);
+}
+
+template <typename W>
+EmergencyResult nearestWithCapacity(int start, int minCapacity) {
+    vector<typename W::Type> dist;
+    vector<int> prev;
+    shortestPaths<W>(start, dist, prev);
+    
+    EmergencyResult result = {false, -1, INF, {}};
+    typename W::Type best = W::infinity();
+    for (const auto& hc : centers) {
+        if (hc.capacity >= minCapacity && hc.id != start && dist[hc.id] < best) {
+            result.found = true;
+            result.nearestID = hc.id;
+            best = dist[hc.id];
+        }
+    }
+    if (result.found) {
+        result.distance = W::km(best);
+        result.path = tracePath(prev, result.nearestID);
+    }
+    return result;
 }
 
 // Emergency routing
@@ -898,56 +2673,1247 @@ void emergencyRouting(int minCapacity) {
         return;
     }
     
-    vector<float> dist(MAX, INF);
-    vector<int> prev(MAX, -1);
-    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
-    
-    dist[start] = 0;
-    pq.push({0, start});
+    EmergencyResult result = nearestWithCapacity(start, minCapacity);
+    if (!result.found) {
+        cout << "No health center found with capacity >= " << minCapacity << ".\n";
+        return;
+    }
     
-    int nearestID = -1;
-    float minDist = INF;
+    cout << "Nearest Health Center with capacity >= " << minCapacity << ": ID " << result.nearestID
+         << ", Distance: " << fixed << setprecision(2) << result.distance << " km\n";
+    printPath(result.path);
+}
+
+// Run a file of queries without prompts and write each result with its latency
+void runBatch(const string& queryFile, const string& resultFile) {
+    ifstream in(queryFile);
+    if (!in.is_open()) {
+        cout << "Error: Cannot open " << queryFile << ".\n";
+        return;
+    }
+    ofstream file(resultFile);
+    BufferedWriter out(file);
+    out.append("Query,Command,Status,Result,LatencyUs\n");
     
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        float d = pq.top().first;
-        pq.pop();
+    map<string, vector<double>> latencies;
+    vector<char> isCenter(adjList.size(), 0);
+    for (const auto& hc : centers) {
+        if (hc.id >= 0 && hc.id < static_cast<int>(isCenter.size())) isCenter[hc.id] = 1;
+    }
+    auto valid = [&isCenter](int id) { return id >= 0 && id < static_cast<int>(isCenter.size()) && isCenter[id]; };
+    string line;
+    size_t queryNo = 0;
+    while (getline(in, line)) {
+        trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        ++queryNo;
         
-        if (d > dist[u]) continue;
+        stringstream ss(line);
+        string command;
+        ss >> command;
+        vector<int> args;
+        int value;
+        while (ss >> value) args.push_back(value);
         
-        auto it = find_if(centers.begin(), centers.end(), [u](const HealthCenter& hc) { return hc.id == u; });
-        if (it != centers.end() && it->capacity >= minCapacity && u != start && d < minDist) {
-            nearestID = u;
-            minDist = d;
-        }
+        // Arguments are checked before the clock starts, so the latency covers only the query itself
+        bool wellFormed = ((command == "dijkstra" || command == "overlay") && args.size() == 2 && valid(args[0]) && valid(args[1]))
+            || (command == "bfs" && args.size() == 1 && valid(args[0]))
+            || (command == "floyd" && args.empty())
+            || (command == "mst" && args.size() == 1 && valid(args[0]))
+            || (command == "emergency" && args.size() == 2 && valid(args[0]))
+            || (command == "fastest" && args.size() == 3 && valid(args[0]) && valid(args[1])
+                && args[2] >= 0 && args[2] % 100 < 60 && args[2] / 100 < 24);
+        ostringstream result;
+        result << fixed << setprecision(2);
+        string status = "ok";
         
-        for (const auto& c : adjList[u]) {
-            if (dist[u] + c.distance < dist[c.to]) {
-                dist[c.to] = dist[u] + c.distance;
-                prev[c.to] = u;
-                pq.push({dist[c.to], c.to});
+        auto t0 = chrono::steady_clock::now();
+        if (!wellFormed) {
+            status = "invalid";
+        } else if (command == "dijkstra" || command == "overlay") {
+            PathResult r = command == "overlay" ? overlayPath(args[0], args[1]) : shortestPath(args[0], args[1]);
+            if (!r.found) status = "no_path";
+            else {
+                result << r.distance << " km:";
+                for (int v : r.path) result << " " << v;
+            }
+        } else if (command == "bfs") {
+            vector<int> order = bfsOrder(args[0]);
+            result << order.size() << " reached:";
+            for (int v : order) result << " " << v;
+        } else if (command == "floyd") {
+            AllPairsResult r = allPairsShortestPaths();
+            size_t reachable = 0;
+            for (const auto& row : r.dist) {
+                for (float d : row) reachable += d != INF;
+            }
+            result << r.ids.size() << " centers; " << reachable << " reachable pairs";
+        } else if (command == "mst") {
+            MSTResult r = minimumSpanningTree(args[0]);
+            result << r.totalWeight << " km over " << r.edges.size() << " edges";
+        } else if (command == "emergency") {
+            EmergencyResult r = nearestWithCapacity(args[0], args[1]);
+            if (!r.found) status = "none";
+            else {
+                result << "ID " << r.nearestID << " " << r.distance << " km:";
+                for (int v : r.path) result << " " << v;
+            }
+        } else if (command == "fastest") {
+            // Departure given as HHMM, e.g. 1730
+            TimedRoute r = fastestRouteAt(args[0], args[1], args[2] / 100 * 60 + args[2] % 100);
+            if (!r.found) status = "no_path";
+            else {
+                result << formatClock(r.departure) << "-" << formatClock(r.arrival) << " " << r.arrival - r.departure << " min:";
+                for (int v : r.path) result << " " << v;
             }
         }
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+        latencies[command].push_back(us);
+        
+        ostringstream row;
+        row << queryNo << "," << command << "," << status << "," << result.str() << "," << fixed << setprecision(1) << us << "\n";
+        out.append(row.str());
     }
+    out.flush();
+    file.close();
     
-    if (nearestID == -1) {
+    cout << "command,count,mean_us,p50_us,p95_us,p99_us,max_us\n";
+    for (auto& entry : latencies) {
+        vector<double>& v = entry.second;
+        sort(v.begin(), v.end());
+        double sum = 0;
+        for (double x : v) sum += x;
+        auto pct = [&v](double q) { return v[min(v.size() - 1, static_cast<size_t>(q * v.size()))]; };
+        cout << entry.first << "," << v.size() << "," << fixed << setprecision(1) << sum / v.size() << ","
+             << pct(0.50) << "," << pct(0.95) << "," << pct(0.99) << "," << v.back() << "\n";
+    }
+    cout << queryNo << " queries written to " << resultFile << "\n";
+}
+
+// Shortest distances from start; fixed weights always use the radix heap, floats the selected queue
+template <typename W>
+void shortestPaths(int start, vector<typename W::Type>& dist, vector<int>& prev) {
+    if constexpr (is_same<W, FixedWeight>::value) {
+        RadixHeap pq(adjList.size());
+        shortestPathTree(adjList, pq, start, dist, prev, W::infinity(), W::of);
+    } else if (activeQueue == QueueKind::RadixHeap) {
+        RadixHeap pq(adjList.size());
+        vector<uint64_t> scaled;
+        shortestPathTree(adjList, pq, start, scaled, prev, UINT64_MAX,
+            [](const Connection& c) { return static_cast<uint64_t>(lround(c.distance * WEIGHT_SCALE)); });
+        dist.assign(adjList.size(), INF);
+        for (size_t v = 0; v < scaled.size(); ++v) {
+            if (scaled[v] != UINT64_MAX) dist[v] = scaled[v] / WEIGHT_SCALE;
+        }
+    } else {
+        QuaternaryHeap<float> pq(adjList.size());
+        shortestPathTree(adjList, pq, start, dist, prev, INF, [](const Connection& c) { return c.distance; });
+    }
+}
+
+// Choose the priority queue used by the shortest-path algorithms
+void selectPriorityQueue() {
+    cout << "Current queue: " << (activeQueue == QueueKind::RadixHeap ? "Radix heap" : "4-ary heap") << "\n";
+    cout << "1. 4-ary heap (exact float distances)\n";
+    cout << "2. Radix heap (distances rounded to 10 m)\n";
+    cout << "Enter choice: ";
+    string input;
+    getline(cin, input);
+    if (input == "1") {
+        activeQueue = QueueKind::QuaternaryHeap;
+    } else if (input == "2") {
+        activeQueue = QueueKind::RadixHeap;
+    } else {
+        cout << "Invalid choice.\n";
+        return;
+    }
+    cout << "Priority queue updated.\n";
+}
+
+// Seeded street grid with a few missing blocks and occasional diagonal shortcuts
+Graph generateRoadGrid(int nodes, unsigned seed, size_t& edges) {
+    int side = max(2, static_cast<int>(sqrt(static_cast<double>(nodes))));
+    int n = side * side;
+    mt19937 rng(seed);
+    uniform_real_distribution<float> segment(0.3f, 4.0f);
+    uniform_real_distribution<float> chance(0.0f, 1.0f);
+    
+    Graph grid(n);
+    edges = 0;
+    auto link = [&](int a, int b) {
+        float km = segment(rng);
+        grid[a].push_back({b, km, toMetres(km), 0, UNLIMITED_THROUGHPUT, -1, -1});
+        grid[b].push_back({a, km, toMetres(km), 0, UNLIMITED_THROUGHPUT, -1, -1});
+        ++edges;
+    };
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int v = r * side + c;
+            if (c + 1 < side && chance(rng) < 0.9f) link(v, v + 1);
+            if (r + 1 < side && chance(rng) < 0.9f) link(v, v + side);
+            if (r + 1 < side && c + 1 < side && chance(rng) < 0.05f) link(v, v + side + 1);
+        }
+    }
+    return grid;
+}
+
+// Microbenchmark: lazy binary heap vs 4-ary heap vs radix heap on a grid-like road graph
+void benchmarkQueues(int nodes, int queries, unsigned seed) {
+    size_t edges = 0;
+    Graph grid = generateRoadGrid(nodes, seed, edges);
+    int n = grid.size();
+    mt19937 rng(seed + 1);
+    
+    vector<int> sources(queries);
+    uniform_int_distribution<int> pick(0, n - 1);
+    for (auto& s : sources) s = pick(rng);
+    
+    cout << "queue,nodes,edges,queries,total_ms,ms_per_query,checksum\n";
+    auto report = [&](const string& name, double ms, double checksum) {
+        cout << name << "," << n << "," << edges << "," << queries << ","
+             << fixed << setprecision(3) << ms << "," << ms / queries << "," << setprecision(1) << checksum << "\n";
+    };
+    
+    vector<float> dist;
+    vector<int> prev;
+    
+    double checksum = 0;
+    auto t0 = chrono::steady_clock::now();
+    for (int s : sources) {
+        dist.assign(n, INF);
+        prev.assign(n, -1);
+        priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
+        dist[s] = 0;
+        pq.push({0, s});
+        while (!pq.empty()) {
+            int u = pq.top().second;
+            float d = pq.top().first;
+            pq.pop();
+            if (d > dist[u]) continue;
+            for (const auto& c : grid[u]) {
+                if (d + c.distance < dist[c.to]) {
+                    dist[c.to] = d + c.distance;
+                    prev[c.to] = u;
+                    pq.push({dist[c.to], c.to});
+                }
+            }
+        }
+        for (float d : dist) if (d != INF) checksum += d;
+    }
+    report("binary_lazy", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count(), checksum);
+    
+    checksum = 0;
+    QuaternaryHeap<float> quaternary(n);
+    t0 = chrono::steady_clock::now();
+    for (int s : sources) {
+        shortestPathTree(grid, quaternary, s, dist, prev, INF, [](const Connection& c) { return c.distance; });
+        for (float d : dist) if (d != INF) checksum += d;
+    }
+    report("quaternary", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count(), checksum);
+    
+    checksum = 0;
+    vector<uint64_t> scaled;
+    RadixHeap radix(n);
+    t0 = chrono::steady_clock::now();
+    for (int s : sources) {
+        shortestPathTree(grid, radix, s, scaled, prev, UINT64_MAX,
+            [](const Connection& c) { return static_cast<uint64_t>(lround(c.distance * WEIGHT_SCALE)); });
+        for (uint64_t d : scaled) if (d != UINT64_MAX) checksum += d / WEIGHT_SCALE;
+    }
+    report("radix", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count(), checksum);
+    
+    // Fixed-weight mode: metres are precomputed per edge, so relaxation is plain integer addition
+    checksum = 0;
+    t0 = chrono::steady_clock::now();
+    for (int s : sources) {
+        shortestPathTree(grid, radix, s, scaled, prev, FixedWeight::infinity(), FixedWeight::of);
+        for (uint64_t d : scaled) if (d != UINT64_MAX) checksum += FixedWeight::km(d);
+    }
+    report("radix_metres", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count(), checksum);
+}
+
+// Length of the shortest direct road between u and v
+template <typename W>
+typename W::Type roadLength(const Graph& adj, int u, int v) {
+    typename W::Type best = W::infinity();
+    for (const auto& c : adj[u]) {
+        if (c.to == v) best = min(best, W::of(c));
+    }
+    return best;
+}
+
+// Yen's algorithm: up to k loopless routes in increasing length, spur searches spread across threads
+vector<RoutePath> kShortestPaths(const Graph& adj, int source, int target, int k, unsigned threads) {
+    if (weightMode == WeightMode::Fixed) return kShortestPaths<FixedWeight>(adj, source, target, k, threads);
+    return kShortestPaths<FloatWeight>(adj, source, target, k, threads);
+}
+
+template <typename W>
+vector<RoutePath> kShortestPaths(const Graph& adj, int source, int target, int k, unsigned threads) {
+    typedef typename W::Type Weight;
+    // Route candidates as (exact length, nodes); converted to km only when returned
+    typedef pair<Weight, vector<int>> Route;
+    vector<Route> found;
+    threads = max(1u, threads);
+    static SpurWorkers<W> workers;
+    workers.prepare(threads, adj.size());
+    
+    Route first;
+    if (workers.workspace(0).run(adj, source, target, {}, first.second, first.first)) found.push_back(first);
+    
+    set<Route> candidates;
+    set<vector<int>> seen = {first.second};
+    
+    while (!found.empty() && static_cast<int>(found.size()) < k) {
+        const vector<int>& last = found.back().second;
+        size_t spurs = last.size() - 1;
+        
+        vector<Weight> rootLength(last.size(), 0);
+        for (size_t j = 1; j < last.size(); ++j) {
+            rootLength[j] = rootLength[j - 1] + roadLength<W>(adj, last[j - 1], last[j]);
+        }
+        
+        // Spur searches from different nodes of the last route are independent
+        vector<vector<Route>> spurResults(threads);
+        function<void(unsigned)> work = [&](unsigned w) {
+            DijkstraWorkspace<W>& ws = workers.workspace(w);
+            vector<int> spurPath, banned;
+            Weight spurLength;
+            for (size_t j = w; j < spurs; j += threads) {
+                int spurNode = last[j];
+                
+                // Roads already used by a found route sharing this root are off limits
+                banned.clear();
+                for (const auto& p : found) {
+                    if (p.second.size() > j + 1 && equal(last.begin(), last.begin() + j + 1, p.second.begin())) {
+                        banned.push_back(p.second[j + 1]);
+                    }
+                }
+                for (size_t r = 0; r < j; ++r) ws.blocked[last[r]] = 1;
+                
+                if (ws.run(adj, spurNode, target, banned, spurPath, spurLength)) {
+                    Route candidate;
+                    candidate.first = rootLength[j] + spurLength;
+                    candidate.second.assign(last.begin(), last.begin() + j);
+                    candidate.second.insert(candidate.second.end(), spurPath.begin(), spurPath.end());
+                    spurResults[w].push_back(candidate);
+                }
+                for (size_t r = 0; r < j; ++r) ws.blocked[last[r]] = 0;
+            }
+        };
+        
+        unsigned active = min<unsigned>(threads, spurs);
+        workers.run(active, work);
+        
+        for (const auto& results : spurResults) {
+            for (const auto& candidate : results) {
+                if (seen.insert(candidate.second).second) candidates.insert(candidate);
+            }
+        }
+        
+        if (candidates.empty()) break;
+        found.push_back(*candidates.begin());
+        candidates.erase(candidates.begin());
+    }
+    
+    vector<RoutePath> routes;
+    for (const auto& r : found) routes.push_back({W::km(r.first), r.second});
+    return routes;
+}
+
+// Display up to k alternative routes between two centers
+void alternativeRoutes() {
+    string input;
+    cout << "Enter start Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int start = stoi(input);
+    cout << "Enter end Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int end = stoi(input);
+    if (!centerExists(start) || !centerExists(end)) {
+        cout << "Error: One or both Health Center IDs not found.\n";
+        return;
+    }
+    if (start == end) {
+        cout << "Error: Start and end must differ.\n";
+        return;
+    }
+    cout << "Enter number of routes (k): ";
+    getline(cin, input);
+    if (!isValidNumber(input) || stoi(input) < 1) {
+        cout << "Error: k must be a positive number.\n";
+        return;
+    }
+    int k = stoi(input);
+    
+    auto t0 = chrono::steady_clock::now();
+    vector<RoutePath> routes = kShortestPaths(adjList, start, end, k, thread::hardware_concurrency());
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    
+    if (routes.empty()) {
+        cout << "No path exists between " << start << " and " << end << ".\n";
+        return;
+    }
+    
+    for (size_t i = 0; i < routes.size(); ++i) {
+        cout << "Route " << i + 1 << ": " << fixed << setprecision(2) << routes[i].length << " km, Path: ";
+        for (size_t j = 0; j < routes[i].nodes.size(); ++j) {
+            cout << routes[i].nodes[j];
+            if (j < routes[i].nodes.size() - 1) cout << " -> ";
+        }
+        cout << "\n";
+    }
+    if (static_cast<int>(routes.size()) < k) {
+        cout << "Only " << routes.size() << " loopless route(s) exist.\n";
+    }
+    cout << "Computed in " << fixed << setprecision(3) << ms << " ms\n";
+}
+
+// Latency of k-shortest routes for k = 3..10, single-threaded vs all cores
+void benchmarkAlternativeRoutes(int nodes, int pairs, unsigned seed) {
+    Graph network;
+    vector<int> ids;
+    size_t edges = 0;
+    if (nodes > 0) {
+        network = generateRoadGrid(nodes, seed, edges);
+        for (size_t v = 0; v < network.size(); ++v) ids.push_back(v);
+    } else {
+        readHealthCenters();
+        readConnections();
+        network = adjList;
+        for (const auto& hc : centers) ids.push_back(hc.id);
+        for (const auto& roads : network) edges += roads.size();
+        edges /= 2;
+    }
+    if (ids.size() < 2) {
+        cout << "Not enough health centers to benchmark.\n";
+        return;
+    }
+    
+    mt19937 rng(seed + 1);
+    uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+    vector<pair<int, int>> queries;
+    while (static_cast<int>(queries.size()) < pairs) {
+        int a = ids[pick(rng)], b = ids[pick(rng)];
+        if (a != b) queries.emplace_back(a, b);
+    }
+    
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    cout << "k,threads,nodes,edges,pairs,avg_ms,max_ms,avg_routes\n";
+    for (int k = 3; k <= 10; ++k) {
+        for (unsigned threads : {1u, cores}) {
+            double total = 0, worst = 0;
+            size_t routes = 0;
+            for (const auto& q : queries) {
+                auto t0 = chrono::steady_clock::now();
+                routes += kShortestPaths(network, q.first, q.second, k, threads).size();
+                double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+                total += ms;
+                worst = max(worst, ms);
+            }
+            cout << k << "," << threads << "," << ids.size() << "," << edges << "," << queries.size() << ","
+                 << fixed << setprecision(3) << total / queries.size() << "," << worst << ","
+                 << setprecision(2) << static_cast<double>(routes) / queries.size() << "\n";
+            if (cores == 1) break;
+        }
+    }
+}
+
+// Read designated dispatch hubs from CSV and build their trees
+void readHubs() {
+    ifstream file(dataPath("hubs.csv"));
+    if (!file.is_open()) return;
+    
+    string line;
+    getline(file, line); // Skip header
+    while (getline(file, line)) {
+        trim(line);
+        if (!isValidNumber(line)) continue;
+        int id = stoi(line);
+        if (centerExists(id)) hubTrees.emplace_back(id);
+    }
+    file.close();
+    rebuildHubTrees();
+}
+
+// Save dispatch hubs to CSV
+void saveHubs() {
+    ofstream file(dataPath("hubs.csv"));
+    file << "HubID\n";
+    for (const auto& t : hubTrees) {
+        file << t.source << "\n";
+    }
+    file.close();
+}
+
+// Full Dijkstra for every hub; used at startup and after bulk changes
+void rebuildHubTrees() {
+    for (auto& t : hubTrees) {
+        shortestPathTree(adjList, t.pq, t.source, t.dist, t.parent, INF, [](const Connection& c) { return c.distance; });
+    }
+}
+
+// Repair one hub tree after the road a-b was added, re-weighted or removed
+void repairHubTree(HubTree& tree, int a, int b) {
+    const Connection* road = nullptr;
+    for (const auto& c : adjList[a]) {
+        if (c.to == b) road = &c;
+    }
+    
+    // A tree edge that got longer or vanished invalidates the subtree below it
+    int child = tree.parent[b] == a ? b : (tree.parent[a] == b ? a : -1);
+    if (child != -1 && (!road || tree.dist[tree.parent[child]] + road->distance > tree.dist[child])) {
+        vector<int> subtree = {child};
+        tree.parent[child] = -1;
+        for (size_t i = 0; i < subtree.size(); ++i) {
+            int v = subtree[i];
+            for (const auto& c : adjList[v]) {
+                if (tree.parent[c.to] == v) {
+                    tree.parent[c.to] = -1;
+                    subtree.push_back(c.to);
+                }
+            }
+        }
+        for (int v : subtree) tree.dist[v] = INF;
+        
+        // Re-attach each orphan through its best neighbour outside the subtree
+        for (int v : subtree) {
+            for (const auto& c : adjList[v]) {
+                if (tree.dist[c.to] != INF && tree.dist[c.to] + c.distance < tree.dist[v]) {
+                    tree.dist[v] = tree.dist[c.to] + c.distance;
+                    tree.parent[v] = c.to;
+                }
+            }
+            if (tree.dist[v] != INF) tree.pq.push(v, tree.dist[v]);
+        }
+    }
+    
+    // A new or shorter road can only improve distances beyond its endpoints
+    if (road) {
+        int ends[2][2] = {{a, b}, {b, a}};
+        for (auto& e : ends) {
+            int u = e[0], v = e[1];
+            if (tree.dist[u] != INF && tree.dist[u] + road->distance < tree.dist[v]) {
+                tree.dist[v] = tree.dist[u] + road->distance;
+                tree.parent[v] = u;
+                tree.pq.push(v, tree.dist[v]);
+            }
+        }
+    }
+    
+    while (!tree.pq.empty()) {
+        int u = tree.pq.pop();
+        for (const auto& c : adjList[u]) {
+            if (tree.dist[u] + c.distance < tree.dist[c.to]) {
+                tree.dist[c.to] = tree.dist[u] + c.distance;
+                tree.parent[c.to] = u;
+                tree.pq.push(c.to, tree.dist[c.to]);
+            }
+        }
+    }
+}
+
+void repairHubTrees(int a, int b) {
+    for (auto& t : hubTrees) {
+        repairHubTree(t, a, b);
+    }
+}
+
+// Add, remove or list dispatch hubs
+void manageHubs() {
+    cout << "Current hubs:";
+    if (hubTrees.empty()) cout << " None";
+    for (const auto& t : hubTrees) cout << " " << t.source;
+    cout << "\n1. Add Hub\n2. Remove Hub\n";
+    cout << "Enter choice: ";
+    string input;
+    getline(cin, input);
+    if (input != "1" && input != "2") {
+        cout << "Invalid choice.\n";
+        return;
+    }
+    bool adding = input == "1";
+    
+    cout << "Enter Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int id = stoi(input);
+    auto it = find_if(hubTrees.begin(), hubTrees.end(), [id](const HubTree& t) { return t.source == id; });
+    
+    if (adding) {
+        if (!centerExists(id)) {
+            cout << "Error: Health Center ID not found.\n";
+            return;
+        }
+        if (it != hubTrees.end()) {
+            cout << "Error: Health Center is already a hub.\n";
+            return;
+        }
+        hubTrees.emplace_back(id);
+        HubTree& t = hubTrees.back();
+        shortestPathTree(adjList, t.pq, t.source, t.dist, t.parent, INF, [](const Connection& c) { return c.distance; });
+        cout << "Hub added successfully.\n";
+    } else {
+        if (it == hubTrees.end()) {
+            cout << "Error: Health Center is not a hub.\n";
+            return;
+        }
+        hubTrees.erase(it);
+        cout << "Hub removed successfully.\n";
+    }
+    saveHubs();
+}
+
+// Answer a dispatch query from a hub's maintained tree without rerunning Dijkstra
+void hubDispatch() {
+    if (hubTrees.empty()) {
+        cout << "No dispatch hubs configured.\n";
+        return;
+    }
+    
+    string input;
+    cout << "Enter hub ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int hub = stoi(input);
+    auto it = find_if(hubTrees.begin(), hubTrees.end(), [hub](const HubTree& t) { return t.source == hub; });
+    if (it == hubTrees.end()) {
+        cout << "Error: Health Center is not a hub.\n";
+        return;
+    }
+    
+    cout << "Enter destination Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int dest = stoi(input);
+    if (!centerExists(dest)) {
+        cout << "Error: Health Center ID not found.\n";
+        return;
+    }
+    
+    if (it->dist[dest] == INF) {
+        cout << "No path exists between " << hub << " and " << dest << ".\n";
+        return;
+    }
+    
+    cout << "Dispatch distance from hub " << hub << " to " << dest << ": " << fixed << setprecision(2) << it->dist[dest] << " km\n";
+    printPath(tracePath(it->parent, dest));
+}
+
+// Capacity lookup indexed by center ID (-1 where no center exists)
+vector<int> buildCapacityIndex() {
+    vector<int> capacityOf(adjList.size(), -1);
+    for (const auto& hc : centers) {
+        capacityOf[hc.id] = hc.capacity;
+    }
+    return capacityOf;
+}
+
+// Bounded Dijkstra over travel time: centers reachable from start within maxMinutes
+vector<pair<int, int>> isochrone(int start, int maxMinutes, int minCapacity, const vector<int>& capacityOf) {
+    vector<int> minutes(adjList.size(), INT_MAX);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+    vector<pair<int, int>> reachable;
+    
+    minutes[start] = 0;
+    pq.push({0, start});
+    
+    while (!pq.empty()) {
+        int u = pq.top().second;
+        int t = pq.top().first;
+        pq.pop();
+        
+        if (t > minutes[u]) continue;
+        
+        if (u != start && capacityOf[u] >= minCapacity) {
+            reachable.emplace_back(u, t);
+        }
+        
+        for (const auto& c : adjList[u]) {
+            int arrival = t + c.time;
+            // Everything beyond the time budget is outside the isochrone
+            if (arrival <= maxMinutes && arrival < minutes[c.to]) {
+                minutes[c.to] = arrival;
+                pq.push({arrival, c.to});
+            }
+        }
+    }
+    return reachable;
+}
+
+// Display centers reachable from a start center within T minutes
+void viewIsochrone() {
+    string input;
+    cout << "Enter start Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int start = stoi(input);
+    if (!centerExists(start)) {
+        cout << "Error: Health Center ID not found.\n";
+        return;
+    }
+    
+    cout << "Enter time budget (minutes): ";
+    getline(cin, input);
+    if (!isValidNumber(input) || stoi(input) < 0) {
+        cout << "Error: Time must be a non-negative number.\n";
+        return;
+    }
+    int maxMinutes = stoi(input);
+    
+    cout << "Enter minimum capacity (0 for any): ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: Capacity must be a valid number.\n";
+        return;
+    }
+    int minCapacity = stoi(input);
+    
+    vector<int> capacityOf = buildCapacityIndex();
+    vector<pair<int, int>> reachable = isochrone(start, maxMinutes, minCapacity, capacityOf);
+    
+    if (reachable.empty()) {
+        cout << "No health centers reachable from " << start << " within " << maxMinutes << " minutes.\n";
+        return;
+    }
+    
+    cout << "\nCenters reachable from " << start << " within " << maxMinutes << " minutes:\n";
+    cout << left << setw(10) << "ID" << setw(25) << "Name" << setw(12) << "Capacity" << setw(10) << "Minutes" << "\n";
+    cout << string(57, '-') << "\n";
+    for (const auto& r : reachable) {
+        auto it = find_if(centers.begin(), centers.end(), [&r](const HealthCenter& hc) { return hc.id == r.first; });
+        cout << left << setw(10) << r.first << setw(25) << it->name
+             << setw(12) << it->capacity << setw(10) << r.second << "\n";
+    }
+}
+
+// Coverage for every center in parallel, aggregated per district
+void isochroneCoverage() {
+    if (centers.empty()) {
+        cout << "No health centers available.\n";
+        return;
+    }
+    
+    string input;
+    cout << "Enter time budget (minutes): ";
+    getline(cin, input);
+    if (!isValidNumber(input) || stoi(input) < 0) {
+        cout << "Error: Time must be a non-negative number.\n";
+        return;
+    }
+    int maxMinutes = stoi(input);
+    
+    cout << "Enter minimum capacity (0 for any): ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: Capacity must be a valid number.\n";
+        return;
+    }
+    int minCapacity = stoi(input);
+    
+    vector<int> capacityOf = buildCapacityIndex();
+    vector<int> coverage(centers.size(), 0);
+    
+    // Each worker takes a strided share of the centers; results land in disjoint slots
+    unsigned workers = max(1u, thread::hardware_concurrency());
+    workers = min<unsigned>(workers, centers.size());
+    vector<thread> pool;
+    for (unsigned w = 0; w < workers; ++w) {
+        pool.emplace_back([&, w]() {
+            for (size_t i = w; i < centers.size(); i += workers) {
+                coverage[i] = isochrone(centers[i].id, maxMinutes, minCapacity, capacityOf).size();
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+    
+    // district -> (centers, total reachable, centers with nothing in reach)
+    map<string, vector<int>> districts;
+    for (size_t i = 0; i < centers.size(); ++i) {
+        auto& d = districts[centers[i].district];
+        if (d.empty()) d.assign(3, 0);
+        d[0]++;
+        d[1] += coverage[i];
+        if (coverage[i] == 0) d[2]++;
+    }
+    
+    ofstream file("isochrone_coverage.csv");
+    file << "Health Center ID,Name,District,Reachable Centers\n";
+    for (size_t i = 0; i < centers.size(); ++i) {
+        file << centers[i].id << "," << centers[i].name << "," << centers[i].district << "," << coverage[i] << "\n";
+    }
+    file.close();
+    
+    vector<pair<float, string>> ranked;
+    for (const auto& d : districts) {
+        ranked.emplace_back(static_cast<float>(d.second[1]) / d.second[0], d.first);
+    }
+    sort(ranked.begin(), ranked.end());
+    
+    cout << "\nCoverage within " << maxMinutes << " minutes (capacity >= " << minCapacity << "), least served first:\n";
+    cout << left << setw(20) << "District" << setw(10) << "Centers" << setw(15) << "Avg Reach" << setw(12) << "Unserved" << "\n";
+    cout << string(57, '-') << "\n";
+    for (const auto& r : ranked) {
+        const auto& d = districts[r.second];
+        cout << left << setw(20) << r.second << setw(10) << d[0]
+             << setw(15) << fixed << setprecision(2) << r.first << setw(12) << d[2] << "\n";
+    }
+    cout << "Per-center coverage exported to isochrone_coverage.csv successfully.\n";
+}
+
+// Multi-source Dijkstra from every center with at least minCapacity; km and source are indexed by ID
+template <typename W>
+bool referralCatchments(int minCapacity, vector<float>& km, vector<int>& source) {
+    typedef typename W::Type Weight;
+    vector<Weight> dist(adjList.size(), W::infinity());
+    source.assign(adjList.size(), -1);
+    QuaternaryHeap<Weight> pq(adjList.size());
+    
+    // Every qualifying center is its own referral point at distance 0
+    for (const auto& hc : centers) {
+        if (hc.capacity >= minCapacity) {
+            dist[hc.id] = 0;
+            source[hc.id] = hc.id;
+            pq.push(hc.id, 0);
+        }
+    }
+    if (pq.empty()) return false;
+    
+    while (!pq.empty()) {
+        int u = pq.pop();
+        for (const auto& c : adjList[u]) {
+            Weight candidate = dist[u] + W::of(c);
+            if (candidate < dist[c.to]) {
+                dist[c.to] = candidate;
+                source[c.to] = source[u];
+                pq.push(c.to, candidate);
+            }
+        }
+    }
+    
+    km.assign(adjList.size(), INF);
+    for (size_t v = 0; v < dist.size(); ++v) {
+        if (dist[v] != W::infinity()) km[v] = W::km(dist[v]);
+    }
+    return true;
+}
+
+// Multi-source Dijkstra: assign every center to its nearest referral center
+void catchmentAssignment(int minCapacity) {
+    vector<float> dist;
+    vector<int> source;
+    bool anyReferral = weightMode == WeightMode::Fixed
+        ? referralCatchments<FixedWeight>(minCapacity, dist, source)
+        : referralCatchments<FloatWeight>(minCapacity, dist, source);
+    
+    if (!anyReferral) {
         cout << "No health center found with capacity >= " << minCapacity << ".\n";
         return;
     }
     
-    cout << "Nearest Health Center with capacity >= " << minCapacity << ": ID " << nearestID
-         << ", Distance: " << fixed << setprecision(2) << minDist << " km\n";
-    cout << "Path: ";
-    vector<int> path;
-    for (int at = nearestID; at != -1; at = prev[at]) {
-        path.push_back(at);
+    // Group by district so each catchment export reads district by district
+    vector<const HealthCenter*> byDistrict;
+    for (const auto& hc : centers) byDistrict.push_back(&hc);
+    stable_sort(byDistrict.begin(), byDistrict.end(),
+        [](const HealthCenter* a, const HealthCenter* b) { return a->district < b->district; });
+    
+    ofstream file("catchment_assignment.csv");
+    file << "District,Health Center ID,Name,Referral Center ID,DistanceKM\n";
+    
+    cout << "\nReferral catchments (capacity >= " << minCapacity << "):\n";
+    cout << left
+         << setw(20) << "District"
+         << setw(10) << "ID"
+         << setw(25) << "Name"
+         << setw(12) << "Referral"
+         << setw(15) << "Distance(km)" << "\n";
+    cout << string(82, '-') << "\n";
+    
+    for (const HealthCenter* hc : byDistrict) {
+        cout << left << setw(20) << hc->district << setw(10) << hc->id << setw(25) << hc->name;
+        file << hc->district << "," << hc->id << "," << hc->name << ",";
+        if (source[hc->id] == -1) {
+            cout << setw(12) << "None" << setw(15) << "INF" << "\n";
+            file << "None,INF\n";
+        } else {
+            cout << setw(12) << source[hc->id] << setw(15) << fixed << setprecision(2) << dist[hc->id] << "\n";
+            file << source[hc->id] << "," << fixed << setprecision(2) << dist[hc->id] << "\n";
+        }
     }
-    reverse(path.begin(), path.end());
-    for (size_t i = 0; i < path.size(); ++i) {
-        cout << path[i];
-        if (i < path.size() - 1) cout << " -> ";
+    
+    file.close();
+    cout << "Catchments exported to catchment_assignment.csv successfully.\n";
+}
+
+// FNV-1a over the breakpoints
+uint64_t hashProfile(const vector<ProfilePoint>& points) {
+    uint64_t h = 14695981039346656037ULL;
+    for (const auto& p : points) {
+        h = (h ^ p.minute) * 1099511628211ULL;
+        h = (h ^ p.permille) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// Shared ID for a sorted breakpoint list, adding it to the pool if it is new
+int internProfile(const vector<ProfilePoint>& points) {
+    uint64_t h = hashProfile(points);
+    auto range = profileIds.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        uint32_t first = profileStart[it->second], last = profileStart[it->second + 1];
+        if (last - first == points.size() && equal(points.begin(), points.end(), profilePoints.begin() + first,
+                                                   [](const ProfilePoint& a, const ProfilePoint& b) {
+                                                       return a.minute == b.minute && a.permille == b.permille;
+                                                   })) {
+            return it->second;
+        }
     }
-    cout << "\n";
+    int id = profileStart.size() - 1;
+    profilePoints.insert(profilePoints.end(), points.begin(), points.end());
+    profileStart.push_back(profilePoints.size());
+    profileIds.emplace(h, id);
+    return id;
+}
+
+// Parse "HH:MM=factor;HH:MM=factor;..." into sorted breakpoints
+bool parseProfile(const string& text, vector<ProfilePoint>& points) {
+    points.clear();
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ';')) {
+        trim(item);
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        if (eq == string::npos) return false;
+        int minute = parseClock(item.substr(0, eq));
+        string factor = item.substr(eq + 1);
+        if (minute < 0 || !isValidFloat(factor)) return false;
+        double f = stod(factor);
+        if (f <= 0 || f > 65.0) return false;
+        points.push_back({static_cast<uint16_t>(minute), static_cast<uint16_t>(lround(f * 1000))});
+    }
+    sort(points.begin(), points.end());
+    for (size_t i = 1; i < points.size(); ++i) {
+        if (points[i].minute == points[i - 1].minute) return false;
+    }
+    return !points.empty();
+}
+
+string formatProfile(int profile) {
+    ostringstream out;
+    out << fixed << setprecision(3);
+    for (uint32_t i = profileStart[profile]; i < profileStart[profile + 1]; ++i) {
+        if (i != profileStart[profile]) out << ";";
+        out << formatClock(profilePoints[i].minute) << "=" << profilePoints[i].permille / 1000.0;
+    }
+    return out.str();
+}
+
+// Fastest-route search is exact only if entering a road later never means leaving it earlier
+bool profileIsFifo(const ProfilePoint* points, int n, int baseMinutes) {
+    for (int i = 0; i < n; ++i) {
+        const ProfilePoint& a = points[i];
+        const ProfilePoint& b = points[i + 1 < n ? i + 1 : 0];
+        int span = (b.minute - a.minute + MINUTES_PER_DAY - 1) % MINUTES_PER_DAY + 1;
+        double drop = (a.permille - b.permille) / 1000.0 * baseMinutes;
+        if (drop > span) return false;
+    }
+    return true;
+}
+
+bool profileIsFifo(int profile, int baseMinutes) {
+    return profileIsFifo(profilePoints.data() + profileStart[profile], profileStart[profile + 1] - profileStart[profile], baseMinutes);
+}
+
+// Load road_profiles.csv (FromID,ToID,Profile); rows for missing roads are ignored
+void readRoadProfiles() {
+    ifstream file(dataPath("road_profiles.csv"));
+    if (!file.is_open()) return;
+    
+    string line;
+    getline(file, line);
+    vector<ProfilePoint> points;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string from, to, text;
+        getline(ss, from, ',');
+        getline(ss, to, ',');
+        getline(ss, text);
+        if (!isValidNumber(from) || !isValidNumber(to) || !parseProfile(text, points)) continue;
+        int r = findRoad(stoi(from), stoi(to));
+        if (r == -1) continue;
+        
+        // Validated before interning, so a rejected profile never enters the pool
+        if (!profileIsFifo(points.data(), points.size(), roads[r].time)) {
+            cout << "Warning: Ignoring time profile for " << from << " - " << to << " (later departures would arrive earlier).\n";
+            continue;
+        }
+        roads[r].profile = internProfile(points);
+        updateRoad(r);
+    }
+    file.close();
+}
+
+void saveRoadProfiles() {
+    ofstream file(dataPath("road_profiles.csv"));
+    file << "FromID,ToID,Profile\n";
+    for (const auto& r : roads) {
+        if (!r.removed && r.profile != -1) {
+            file << r.from << "," << r.to << "," << formatProfile(r.profile) << "\n";
+        }
+    }
+    file.close();
+}
+
+// Minutes needed to traverse c when entering it at absolute minute at
+double travelMinutes(const Connection& c, double at) {
+    if (c.profile == -1) return c.time;
+    const ProfilePoint* p = profilePoints.data() + profileStart[c.profile];
+    int n = profileStart[c.profile + 1] - profileStart[c.profile];
+    double minute = fmod(at, MINUTES_PER_DAY);
+    
+    // Interpolate between the surrounding breakpoints; the profile wraps around midnight
+    int i = upper_bound(p, p + n, minute, [](double m, const ProfilePoint& q) { return m < q.minute; }) - p;
+    const ProfilePoint& a = p[i == 0 ? n - 1 : i - 1];
+    const ProfilePoint& b = p[i == n ? 0 : i];
+    double from = a.minute - (i == 0 ? MINUTES_PER_DAY : 0);
+    double to = b.minute + (i == n ? MINUTES_PER_DAY : 0);
+    double permille = a.permille + (b.permille - a.permille) * (minute - from) / (to - from);
+    return c.time * permille / 1000.0;
+}
+
+// Time-dependent Dijkstra: labels are earliest arrival times, so each road is costed at the moment it is entered
+TimedRoute fastestRouteAt(int start, int end, double departure) {
+    vector<double> arrival(adjList.size(), numeric_limits<double>::infinity());
+    vector<int> prev(adjList.size(), -1);
+    QuaternaryHeap<double> pq(adjList.size());
+    arrival[start] = departure;
+    pq.push(start, departure);
+    
+    while (!pq.empty()) {
+        int u = pq.pop();
+        if (u == end) break;
+        for (const auto& c : adjList[u]) {
+            double candidate = arrival[u] + travelMinutes(c, arrival[u]);
+            if (candidate < arrival[c.to]) {
+                arrival[c.to] = candidate;
+                prev[c.to] = u;
+                pq.push(c.to, candidate);
+            }
+        }
+    }
+    
+    TimedRoute result = {prev[end] != -1 || start == end, departure, arrival[end], {}};
+    if (result.found) result.path = tracePath(prev, end);
+    return result;
+}
+
+// "HH:MM" to minutes after midnight, or -1
+int parseClock(const string& text) {
+    size_t colon = text.find(':');
+    if (colon == string::npos) return -1;
+    string hours = text.substr(0, colon), minutes = text.substr(colon + 1);
+    trim(hours);
+    trim(minutes);
+    if (!isValidNumber(hours) || !isValidNumber(minutes)) return -1;
+    int h = stoi(hours), m = stoi(minutes);
+    if (h < 0 || h > 23 || m < 0 || m > 59) return -1;
+    return h * 60 + m;
+}
+
+// Absolute minutes as "HH:MM", with "+Nd" once the route runs past midnight
+string formatClock(double minutes) {
+    long total = lround(minutes);
+    char text[24];
+    snprintf(text, sizeof(text), "%02ld:%02ld", total / 60 % 24, total % 60);
+    string clock = text;
+    if (total >= MINUTES_PER_DAY) clock += "+" + to_string(total / MINUTES_PER_DAY) + "d";
+    return clock;
+}
+
+// Fastest route for a given departure time, using each road's time profile
+void timeDependentRoute() {
+    string input;
+    cout << "Enter start Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int start = stoi(input);
+    
+    cout << "Enter end Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int end = stoi(input);
+    
+    if (!centerExists(start) || !centerExists(end)) {
+        cout << "Error: One or both Health Center IDs not found.\n";
+        return;
+    }
+    
+    cout << "Enter departure time (HH:MM): ";
+    getline(cin, input);
+    int departure = parseClock(input);
+    if (departure < 0) {
+        cout << "Error: Time must be in HH:MM format.\n";
+        return;
+    }
+    
+    TimedRoute route = fastestRouteAt(start, end, departure);
+    if (!route.found) {
+        cout << "No path exists between " << start << " and " << end << ".\n";
+        return;
+    }
+    cout << "Depart " << formatClock(route.departure) << ", arrive " << formatClock(route.arrival)
+         << " (" << fixed << setprecision(1) << route.arrival - route.departure << " minutes)\n";
+    printPath(route.path);
+}
+
+// Attach, replace or clear the daily time profile of a road
+void setRoadProfile() {
+    string input;
+    cout << "Enter From ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int fromID = stoi(input);
+    
+    cout << "Enter To ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int toID = stoi(input);
+    
+    int r = findRoad(fromID, toID);
+    if (r == -1) {
+        cout << "Error: Connection not found.\n";
+        return;
+    }
+    
+    cout << "Current profile: " << (roads[r].profile == -1 ? "constant " + to_string(roads[r].time) + " minutes" : formatProfile(roads[r].profile)) << "\n";
+    cout << "Enter profile as HH:MM=factor;... (e.g. 07:00=1.0;08:00=1.8;10:00=1.0), empty to clear: ";
+    getline(cin, input);
+    trim(input);
+    
+    if (input.empty()) {
+        roads[r].profile = -1;
+    } else {
+        vector<ProfilePoint> points;
+        if (!parseProfile(input, points)) {
+            cout << "Error: Invalid profile.\n";
+            return;
+        }
+        if (!profileIsFifo(points.data(), points.size(), roads[r].time)) {
+            cout << "Error: Profile drops too steeply; a later departure would arrive earlier.\n";
+            return;
+        }
+        roads[r].profile = internProfile(points);
+    }
+    updateRoad(r);
+    saveRoadProfiles();
+    cout << "Time profile updated successfully.\n";
+}
+
+// Shortest path answered over the district overlay; same result as shortestPath
+PathResult overlayPath(int start, int end) {
+    return weightMode == WeightMode::Fixed ? overlayPath<FixedWeight>(start, end) : overlayPath<FloatWeight>(start, end);
+}
+
+template <typename W>
+PathResult overlayPath(int start, int end) {
+    typename W::Type length;
+    PathResult result = {false, INF, {}};
+    if (districtOverlay<W>().route(start, end, length, result.path)) {
+        result.found = true;
+        result.distance = W::km(length);
+    }
+    return result;
+}
+
+// Only the districts at either end of an edited road are recomputed, on the next query
+void overlayRoadChanged(int a, int b) {
+    districtOverlay<FloatWeight>().roadChanged(a, b);
+    districtOverlay<FixedWeight>().roadChanged(a, b);
+}
+
+void invalidateOverlay() {
+    districtOverlay<FloatWeight>().invalidate();
+    districtOverlay<FixedWeight>().invalidate();
+}
+
+// Shortest path through the district overlay, with partition statistics
+void partitionedRoute() {
+    string input;
+    cout << "Enter start Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int start = stoi(input);
+    
+    cout << "Enter end Health Center ID: ";
+    getline(cin, input);
+    if (!isValidNumber(input)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    int end = stoi(input);
+    
+    if (!centerExists(start) || !centerExists(end)) {
+        cout << "Error: One or both Health Center IDs not found.\n";
+        return;
+    }
+    
+    auto t0 = chrono::steady_clock::now();
+    PathResult result = overlayPath(start, end);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    
+    size_t districts, boundary, cells;
+    if (weightMode == WeightMode::Fixed) {
+        const auto& o = districtOverlay<FixedWeight>();
+        districts = o.districts(), boundary = o.boundaryNodes(), cells = o.cellEntries();
+    } else {
+        const auto& o = districtOverlay<FloatWeight>();
+        districts = o.districts(), boundary = o.boundaryNodes(), cells = o.cellEntries();
+    }
+    cout << "Overlay: " << districts << " districts, " << boundary << " boundary centers, "
+         << cells << " cell entries (" << fixed << setprecision(2) << ms << " ms)\n";
+    
+    if (!result.found) {
+        cout << "No path exists between " << start << " and " << end << ".\n";
+        return;
+    }
+    cout << "Shortest distance from " << start << " to " << end << ": " << fixed << setprecision(2) << result.distance << " km\n";
+    printPath(result.path);
 }
 
 // Utility functions
@@ -4,7 +4,25 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <cctype>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
 #include <iomanip>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -49,6 +67,759 @@ struct Edge {
     float distance;
 };
 
+// One file holding every hospital's patients, doctors and appointments.
+// Layout: a fixed-size header pointing at the latest index, then append-only record lines
+// "<type>,<hospital_id>,<fields>". The index lists each hospital's segments (contiguous runs of
+// one record type), so startup maps the file once and reads only the index plus any records
+// appended after it; each insert is a single append at the end of the file.
+class HospitalStore {
+public:
+    static constexpr char PATIENT = 'P';
+    static constexpr char DOCTOR = 'D';
+    static constexpr char APPOINTMENT = 'A';
+
+    HospitalStore() : fd(-1), base(nullptr), mapped(0), file_end(0),
+                      index_offset(0), index_length(0), garbage(0), created(false) {}
+
+    ~HospitalStore() {
+        checkpoint();
+        unmap();
+        if (fd != -1) close(fd);
+    }
+
+    // Map an existing store, reading its index and any records appended after it, or create an empty one
+    void open(const string& file) {
+        path = file;
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd == -1) {
+            cout << "Error: Cannot open " << path << ".\n";
+            return;
+        }
+        struct stat st;
+        fstat(fd, &st);
+        file_end = st.st_size;
+        if (file_end == 0) {
+            created = true;
+            file_end = HEADER_SIZE;
+            index_offset = HEADER_SIZE;
+            if (!writeHeader()) {
+                cout << "Error: Cannot write " << path << ".\n";
+                close(fd);
+                fd = -1;
+            }
+            return;
+        }
+
+        ensureMapped(file_end);
+        unsigned long long offset = 0, length = 0;
+        if (file_end < HEADER_SIZE || string(base, 8) != "HSTORE01" ||
+            sscanf(base + 9, "%llu %llu", &offset, &length) != 2 || offset + length > file_end) {
+            cout << "Error: " << path << " is not a hospital store.\n";
+            close(fd);
+            fd = -1;
+            return;
+        }
+        index_offset = offset;
+        index_length = length;
+        readIndex();
+        scan(max<uint64_t>(HEADER_SIZE, index_offset + index_length), file_end);
+    }
+
+    // Map the whole file so concurrent readers never need to remap
+    void mapAll() { ensureMapped(file_end); }
+
+    // Bytes of records stored for a hospital
+    uint64_t recordBytes(const string& hospital_id) const {
+        auto it = segments.find(hospital_id);
+        if (it == segments.end()) return 0;
+        uint64_t total = 0;
+        for (const auto& list : it->second) {
+            for (const auto& seg : list) total += seg.length;
+        }
+        return total;
+    }
+
+    // True if the file did not exist before this run
+    bool isNew() const { return created; }
+
+    uint64_t size() const { return file_end; }
+
+    // Changes whenever a hospital's records of this type do and is unaffected by other records or compaction,
+    // so a saved patient or doctor index can tell whether it still describes the store
+    uint64_t stamp(char type) const { return stamps[slotOf(type)]; }
+
+    vector<string> hospitalIDs() const {
+        vector<string> ids;
+        for (const auto& h : segments) ids.push_back(h.first);
+        return ids;
+    }
+
+    // Append one record; fields are the CSV columns after the hospital ID. False if it did not reach the file
+    bool append(const string& hospital_id, char type, const string& fields) {
+        return append(hospital_id, {{type, fields}});
+    }
+
+    // Append several (type, fields) records of one hospital with a single write; none are added on failure
+    bool append(const string& hospital_id, const vector<pair<char, string>>& records) {
+        string bytes;
+        vector<size_t> starts;
+        for (const auto& r : records) {
+            starts.push_back(bytes.size());
+            bytes += string(1, r.first) + "," + hospital_id + "," + r.second + "\n";
+        }
+        uint64_t offset = file_end;
+        if (!write(bytes)) return false;
+        for (size_t i = 0; i < records.size(); ++i) {
+            size_t end = i + 1 < records.size() ? starts[i + 1] : bytes.size();
+            addSegment(hospital_id, records[i].first, offset + starts[i], end - starts[i]);
+        }
+        return true;
+    }
+
+    // Drop every record of a hospital; the bytes are reclaimed by the next compaction.
+    // False, with the records kept, if the tombstone did not reach the file
+    bool removeHospital(const string& hospital_id) {
+        string line = "X," + hospital_id + "\n";
+        if (!write(line)) return false;
+        dropSegments(hospital_id);
+        garbage += line.size();
+        return true;
+    }
+
+    // Call visit with the fields of each record of one type for a hospital, in insertion order
+    template <typename F>
+    void forEach(const string& hospital_id, char type, F visit) {
+        auto it = segments.find(hospital_id);
+        if (it == segments.end()) return;
+        size_t prefix = hospital_id.size() + 3;
+        for (const auto& seg : it->second[slotOf(type)]) {
+            ensureMapped(seg.offset + seg.length);
+            const char* p = base + seg.offset;
+            const char* end = p + seg.length;
+            while (p < end) {
+                const char* eol = find(p, end, '\n');
+                visit(string(p + prefix, eol));
+                p = eol + 1;
+            }
+        }
+    }
+
+    // Persist the index so the next startup need not scan the records appended during this run
+    void checkpoint() {
+        if (fd == -1 || file_end == index_offset + index_length) return;
+        size_t lists = 0, pieces = 0, live = 0;
+        for (const auto& h : segments) {
+            for (const auto& list : h.second) {
+                lists += !list.empty();
+                pieces += list.size();
+                for (const auto& seg : list) live += seg.length;
+            }
+        }
+        if (garbage > live || pieces > 2 * lists + 64) compact();
+        else writeIndex();
+    }
+
+private:
+    struct Segment {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    static constexpr size_t HEADER_SIZE = 51; // "HSTORE01 <index offset:20> <index length:20>\n"
+
+    string path;
+    int fd;
+    char* base;
+    size_t mapped;
+    uint64_t file_end;
+    uint64_t index_offset;
+    uint64_t index_length;
+    uint64_t garbage; // Bytes no longer referenced: old indexes, deleted hospitals
+    bool created;
+    map<string, array<vector<Segment>, 3>> segments;
+    // Per record type: each hospital's bytes, and the sum of mix(hospital, bytes) over hospitals
+    array<unordered_map<string, uint64_t>, 3> type_bytes;
+    array<uint64_t, 3> stamps{};
+
+    static int slotOf(char type) { return type == PATIENT ? 0 : type == DOCTOR ? 1 : 2; }
+
+    // FNV-1a over the hospital ID and byte count, then a final avalanche; hospitals without such records add nothing
+    static uint64_t mix(const string& hospital_id, uint64_t bytes) {
+        if (bytes == 0) return 0;
+        uint64_t h = 14695981039346656037ULL;
+        for (char c : hospital_id) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        for (int i = 0; i < 8; ++i) h = (h ^ ((bytes >> (8 * i)) & 0xff)) * 1099511628211ULL;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    void countBytes(const string& hospital_id, char type, uint64_t bytes) {
+        int slot = slotOf(type);
+        uint64_t& total = type_bytes[slot][hospital_id];
+        stamps[slot] -= mix(hospital_id, total);
+        total += bytes;
+        stamps[slot] += mix(hospital_id, total);
+    }
+
+    bool writeHeader() {
+        char header[HEADER_SIZE + 1];
+        snprintf(header, sizeof(header), "HSTORE01 %020llu %020llu\n",
+                 (unsigned long long)index_offset, (unsigned long long)index_length);
+        return pwrite(fd, header, HEADER_SIZE, 0) == (ssize_t)HEADER_SIZE;
+    }
+
+    // Append at the end of the file; a short write is cut off again so the next append starts on a clean line
+    bool write(const string& bytes) {
+        if (fd == -1) return false;
+        if (pwrite(fd, bytes.data(), bytes.size(), file_end) != (ssize_t)bytes.size()) {
+            if (ftruncate(fd, file_end) != 0) {
+                // Stop writing rather than leave a partial line that a later append would run on from
+                close(fd);
+                fd = -1;
+            }
+            return false;
+        }
+        file_end += bytes.size();
+        return true;
+    }
+
+    void unmap() {
+        if (base) munmap(base, mapped);
+        base = nullptr;
+        mapped = 0;
+    }
+
+    // Records appended since the last mapping are only visible after remapping
+    void ensureMapped(uint64_t end) {
+        if (end <= mapped) return;
+        unmap();
+        void* p = mmap(nullptr, file_end, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return;
+        base = static_cast<char*>(p);
+        mapped = file_end;
+    }
+
+    void dropSegments(const string& hospital_id) {
+        auto it = segments.find(hospital_id);
+        if (it == segments.end()) return;
+        for (const auto& list : it->second) {
+            for (const auto& seg : list) garbage += seg.length;
+        }
+        segments.erase(it);
+        for (int slot = 0; slot < 3; ++slot) {
+            stamps[slot] -= mix(hospital_id, type_bytes[slot][hospital_id]);
+            type_bytes[slot].erase(hospital_id);
+        }
+    }
+
+    void addSegment(const string& hospital_id, char type, uint64_t offset, uint64_t length) {
+        vector<Segment>& list = segments[hospital_id][slotOf(type)];
+        countBytes(hospital_id, type, length);
+        if (!list.empty() && list.back().offset + list.back().length == offset) list.back().length += length;
+        else list.push_back({offset, length});
+    }
+
+    // Index lines: "#,<hospital_id>,<type>,<offset>,<length>"
+    void readIndex() {
+        const char* p = base + index_offset;
+        const char* end = p + index_length;
+        while (p < end) {
+            const char* eol = find(p, end, '\n');
+            stringstream ss(string(p, eol));
+            string tag, id, type, offset, length;
+            getline(ss, tag, ',');
+            getline(ss, id, ',');
+            getline(ss, type, ',');
+            getline(ss, offset, ',');
+            getline(ss, length);
+            if (tag == "#" && type.size() == 1) {
+                segments[id][slotOf(type[0])].push_back({stoull(offset), stoull(length)});
+                countBytes(id, type[0], stoull(length));
+            }
+            p = eol + 1;
+        }
+    }
+
+    // Pick up records written after the index; stale indexes from interrupted checkpoints are skipped.
+    // A final line without its newline is a torn append from a crash and is cut off, so the next
+    // append does not run on from it.
+    void scan(uint64_t from, uint64_t to) {
+        const char* p = base + from;
+        const char* end = base + to;
+        while (p < end) {
+            const char* eol = find(p, end, '\n');
+            uint64_t offset = p - base, length = eol - p + 1;
+            if (eol == end) {
+                if (ftruncate(fd, offset) == 0) file_end = offset;
+                break;
+            }
+            if (eol - p < 2 || p[1] != ',') {
+                garbage += length;
+                p = eol + 1;
+                continue;
+            }
+            const char* comma = find(p + 2, eol, ',');
+            string id(p + 2, comma);
+            if (*p == 'X') {
+                dropSegments(id);
+                garbage += length;
+            } else if (*p == PATIENT || *p == DOCTOR || *p == APPOINTMENT) {
+                addSegment(id, *p, offset, length);
+            } else {
+                garbage += length;
+            }
+            p = eol + 1;
+        }
+    }
+
+    // False if the index or header did not reach the disk; the previous header then still points at the old index
+    bool writeIndex() {
+        string index;
+        for (const auto& h : segments) {
+            for (char type : {PATIENT, DOCTOR, APPOINTMENT}) {
+                for (const auto& seg : h.second[slotOf(type)]) {
+                    index += "#," + h.first + "," + type + "," + to_string(seg.offset) + "," + to_string(seg.length) + "\n";
+                }
+            }
+        }
+        uint64_t offset = file_end;
+        // The index must be on disk before the header points at it, and the header before we rely on it
+        if (!write(index) || fsync(fd) != 0) return false;
+        uint64_t old_offset = index_offset, old_length = index_length;
+        index_offset = offset;
+        index_length = index.size();
+        if (!writeHeader() || fsync(fd) != 0) {
+            index_offset = old_offset;
+            index_length = old_length;
+            return false;
+        }
+        garbage += old_length;
+        return true;
+    }
+
+    // Rewrite the file with each hospital's lists stored contiguously, dropping dead bytes
+    void compact() {
+        string temp_path = path + ".tmp";
+        int out = ::open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (out == -1) {
+            writeIndex();
+            return;
+        }
+        ensureMapped(file_end);
+        auto packed = segments;
+        uint64_t end = HEADER_SIZE;
+        bool ok = true;
+        for (auto& h : packed) {
+            for (auto& list : h.second) {
+                uint64_t start = end;
+                for (const auto& seg : list) {
+                    ok = ok && pwrite(out, base + seg.offset, seg.length, end) == (ssize_t)seg.length;
+                    end += seg.length;
+                }
+                if (end > start) list.assign(1, {start, end - start});
+                else list.clear();
+            }
+        }
+        if (!ok) {
+            // Keep the current file and write its index in place instead
+            close(out);
+            unlink(temp_path.c_str());
+            writeIndex();
+            return;
+        }
+
+        int old_fd = fd;
+        uint64_t old_end = file_end, old_offset = index_offset, old_length = index_length;
+        fd = out;
+        file_end = end;
+        index_length = 0;
+        segments.swap(packed);
+        if (!writeIndex() || rename(temp_path.c_str(), path.c_str()) != 0) {
+            if (fd != -1) close(out);
+            unlink(temp_path.c_str());
+            fd = old_fd;
+            file_end = old_end;
+            index_offset = old_offset;
+            index_length = old_length;
+            segments.swap(packed);
+            writeIndex();
+            return;
+        }
+        unmap();
+        close(old_fd);
+        garbage = 0;
+        syncDirectory();
+    }
+
+    // Make a rename in the store's directory durable
+    void syncDirectory() {
+        size_t slash = path.find_last_of('/');
+        string dir = slash == string::npos ? "." : path.substr(0, slash + 1);
+        int dfd = ::open(dir.c_str(), O_RDONLY);
+        if (dfd == -1) return;
+        fsync(dfd);
+        close(dfd);
+    }
+};
+
+// Where each patient, or each doctor, is registered, by ID and by normalized name, across all hospitals.
+// Loaded on the first lookup, so startup only checks the file's last stamp. Each change is appended to
+// the file as a delta line ending in the store's stamp for the record type, whether or not the index is
+// loaded yet, so a session that only registers people leaves a file that still matches. A file whose
+// last stamp disagrees with the store, or that does not parse, is rebuilt from the store's records.
+// File: "<tag>,<stamp>", then "E,<hospital>,<id>,<name>,<detail>" entries, then deltas
+// "+,<hospital>,<id>,<name>,<detail>,<stamp>" and "-,<hospital>,<stamp>".
+class PersonIndex {
+public:
+    struct Entry {
+        string hospital_id;
+        int id;
+        string name;
+        string detail; // Date of birth of a patient, specialization of a doctor
+    };
+
+    // tag heads the file and names the index; type is the store record type it covers
+    PersonIndex(string file, string tag, char type) : path(file), tag(tag + ","), type(type), trie(1) {}
+
+    // Start appending deltas if the file's last stamp matches the store; otherwise the first lookup rebuilds it
+    void open(uint64_t stamp) {
+        if (lastStamp() == to_string(stamp)) log.open(path, ios::app);
+    }
+
+    // Call after the person's record has been appended to the store
+    void add(const string& hospital_id, int id, const string& name, const string& detail, uint64_t stamp) {
+        if (loaded) insert({hospital_id, id, name, detail});
+        log << "+," << hospital_id << "," << id << "," << name << "," << detail << "," << stamp << "\n" << flush;
+        checkLog();
+    }
+
+    // Call after the hospital has been removed from the store
+    void removeHospital(const string& hospital_id, uint64_t stamp) {
+        if (loaded) drop(hospital_id);
+        log << "-," << hospital_id << "," << stamp << "\n" << flush;
+        checkLog();
+    }
+
+    bool isLoaded() const { return loaded; }
+
+    // Read the saved index, or rebuild it from every record of its type in the store if it is stale or corrupt
+    void load(HospitalStore& store) {
+        if (loaded) return;
+        loaded = true;
+        bool current = false;
+        if (log.is_open()) {
+            try {
+                current = read() == to_string(store.stamp(type));
+            } catch (const exception&) {
+                current = false;
+            }
+        }
+        if (!current) {
+            clear();
+            for (const auto& hospital_id : store.hospitalIDs()) {
+                store.forEach(hospital_id, type, [&](const string& record) {
+                    stringstream ss(record);
+                    Entry e;
+                    string id;
+                    e.hospital_id = hospital_id;
+                    getline(ss, id, ',');
+                    getline(ss, e.name, ',');
+                    getline(ss, e.detail, ',');
+                    e.id = stoi(id);
+                    insert(move(e));
+                });
+            }
+            save(store.stamp(type));
+        }
+    }
+
+    // Rewrite the file as plain entries, folding in the deltas appended so far; an index that was
+    // never loaded has nothing to fold in
+    void save(uint64_t stamp) {
+        if (!loaded) return;
+        string temp_path = path + ".tmp";
+        ofstream file(temp_path);
+        file << tag << stamp << "\n";
+        for (const auto& e : entries) {
+            file << "E," << e.hospital_id << "," << e.id << "," << e.name << "," << e.detail << "\n";
+        }
+        file.close();
+        if (!file) return;
+        if (log.is_open()) log.close();
+        rename(temp_path.c_str(), path.c_str());
+        log.open(path, ios::app);
+    }
+
+    vector<Entry> findById(int id) const {
+        vector<Entry> found;
+        auto it = by_id.find(id);
+        if (it != by_id.end()) {
+            for (size_t i : it->second) found.push_back(entries[i]);
+        }
+        return found;
+    }
+
+    vector<Entry> findByName(const string& name) const {
+        vector<Entry> found;
+        int v = locate(normalize(name));
+        if (v >= 0) {
+            for (size_t i : trie[v].people) found.push_back(entries[i]);
+        }
+        return found;
+    }
+
+    // Up to limit registrations whose name starts with prefix, in name order
+    vector<Entry> findByPrefix(const string& prefix, size_t limit) const {
+        vector<Entry> found;
+        string p = normalize(prefix);
+        int v = p.empty() ? -1 : prefixNode(p);
+        if (v < 0) return found;
+        vector<int> stack{v};
+        while (!stack.empty()) {
+            const Node& n = trie[stack.back()];
+            stack.pop_back();
+            for (size_t i : n.people) {
+                if (found.size() == limit) return found;
+                found.push_back(entries[i]);
+            }
+            for (auto c = n.children.rbegin(); c != n.children.rend(); ++c) stack.push_back(c->second);
+        }
+        return found;
+    }
+
+    // Up to limit registrations whose name is within 1 edit of the query (2 from 8 letters), fewest edits
+    // first and paired with the count; swapping two adjacent letters is one edit. The trie is walked
+    // depth first with one row of the edit-distance table per letter of the path, and a branch is left
+    // as soon as every entry of its last row is over the limit, since later rows never go below that.
+    vector<pair<int, Entry>> findByNameFuzzy(const string& name, size_t limit) const {
+        vector<pair<int, Entry>> found;
+        string q = normalize(name);
+        if (q.empty()) return found;
+        int max_edits = q.size() >= 8 ? 2 : 1;
+        size_t width = q.size() + 1;
+        vector<int> rows(width); // Row i, at rows[i * width], holds the distances from path's first i letters
+        for (size_t j = 0; j < width; ++j) rows[j] = j;
+        string path;
+        // Fill the row for path letter depth + 1 being c and return its smallest entry
+        auto step = [&](size_t depth, char c) {
+            rows.resize(max(rows.size(), (depth + 2) * width));
+            const int* above = &rows[depth * width];
+            int* row = &rows[(depth + 1) * width];
+            row[0] = depth + 1;
+            int best = row[0];
+            for (size_t j = 1; j < width; ++j) {
+                row[j] = min({above[j] + 1, row[j - 1] + 1, above[j - 1] + (q[j - 1] != c)});
+                if (depth > 0 && j > 1 && q[j - 1] == path[depth - 1] && q[j - 2] == c) {
+                    row[j] = min(row[j], rows[(depth - 1) * width + j - 2] + 1);
+                }
+                best = min(best, row[j]);
+            }
+            return best;
+        };
+        vector<pair<int, size_t>> stack{{0, 0}}; // Node and the length of the path above its label
+        while (!stack.empty()) {
+            const Node& n = trie[stack.back().first];
+            size_t depth = stack.back().second;
+            stack.pop_back();
+            path.resize(depth);
+            bool too_far = false;
+            for (size_t k = 0; k < n.label.size() && !too_far; ++k, ++depth) {
+                too_far = step(depth, n.label[k]) > max_edits;
+                path += n.label[k];
+            }
+            if (too_far) continue;
+            int edits = rows[depth * width + q.size()];
+            if (edits <= max_edits) {
+                for (size_t i : n.people) found.push_back({edits, entries[i]});
+            }
+            // A child's first letter is stored here, so most branches are cut without reading the child
+            for (auto c = n.children.rbegin(); c != n.children.rend(); ++c) {
+                if (step(depth, c->first) <= max_edits) stack.push_back({c->second, depth});
+            }
+        }
+        stable_sort(found.begin(), found.end(), [](const pair<int, Entry>& a, const pair<int, Entry>& b) { return a.first < b.first; });
+        if (found.size() > limit) found.resize(limit);
+        return found;
+    }
+
+    // Lower case with single spaces, so "  Jane  DOE" matches "jane doe"
+    static string normalize(const string& name) {
+        string out;
+        for (char c : name) {
+            if (isspace(static_cast<unsigned char>(c))) {
+                if (!out.empty() && out.back() != ' ') out += ' ';
+            } else {
+                out += tolower(static_cast<unsigned char>(c));
+            }
+        }
+        if (!out.empty() && out.back() == ' ') out.pop_back();
+        return out;
+    }
+
+private:
+    string path;
+    string tag;
+    char type;
+    ofstream log; // Open only while the file matches the store
+    bool loaded = false;
+    vector<Entry> entries;
+    unordered_map<int, vector<size_t>> by_id;
+
+    // Radix trie over normalized names; each edge holds a run of letters, and a node lists the entries
+    // whose name ends there. Children are sorted, so a walk meets names in alphabetical order.
+    struct Node {
+        string label; // Letters on the edge into this node
+        vector<pair<char, int>> children; // First letter of the child's label, child
+        vector<size_t> people;
+    };
+    vector<Node> trie;
+
+    void insert(Entry e) {
+        by_id[e.id].push_back(entries.size());
+        trie[place(normalize(e.name))].people.push_back(entries.size());
+        entries.push_back(move(e));
+    }
+
+    int child(int v, char c) const {
+        const auto& ch = trie[v].children;
+        auto it = lower_bound(ch.begin(), ch.end(), c, [](const pair<char, int>& a, char c) { return a.first < c; });
+        return it != ch.end() && it->first == c ? it->second : -1;
+    }
+
+    // The node a name ends at, created if needed
+    int place(const string& name) {
+        int v = 0;
+        size_t i = 0;
+        while (i < name.size()) {
+            int c = child(v, name[i]);
+            if (c < 0) {
+                int n = trie.size();
+                trie.push_back({name.substr(i), {}, {}});
+                auto& ch = trie[v].children;
+                ch.insert(lower_bound(ch.begin(), ch.end(), make_pair(name[i], n)), {name[i], n});
+                return n;
+            }
+            size_t l = 0;
+            const string& label = trie[c].label;
+            while (l < label.size() && i + l < name.size() && label[l] == name[i + l]) ++l;
+            if (l < label.size()) {
+                // Split the edge: the shared letters become a new node above the old child
+                int mid = trie.size();
+                Node shared{label.substr(0, l), {{label[l], c}}, {}};
+                trie[c].label.erase(0, l);
+                trie.push_back(move(shared));
+                for (auto& ch : trie[v].children) {
+                    if (ch.second == c) ch.second = mid;
+                }
+                c = mid;
+            }
+            v = c;
+            i += l;
+        }
+        return v;
+    }
+
+    // The node a name ends at, or -1
+    int locate(const string& name) const {
+        int v = 0;
+        size_t i = 0;
+        while (i < name.size()) {
+            int c = child(v, name[i]);
+            if (c < 0 || name.compare(i, trie[c].label.size(), trie[c].label) != 0) return -1;
+            i += trie[c].label.size();
+            v = c;
+        }
+        return v;
+    }
+
+    // The node under which every name starting with p lies, or -1; p may end inside its label
+    int prefixNode(const string& p) const {
+        int v = 0;
+        size_t i = 0;
+        while (i < p.size()) {
+            int c = child(v, p[i]);
+            if (c < 0) return -1;
+            size_t n = min(trie[c].label.size(), p.size() - i);
+            if (p.compare(i, n, trie[c].label, 0, n) != 0) return -1;
+            v = c;
+            i += n;
+        }
+        return v;
+    }
+
+    void clear() {
+        entries.clear();
+        by_id.clear();
+        trie.assign(1, Node());
+    }
+
+    void drop(const string& hospital_id) {
+        vector<Entry> kept;
+        for (auto& e : entries) {
+            if (e.hospital_id != hospital_id) kept.push_back(move(e));
+        }
+        clear();
+        for (auto& e : kept) insert(move(e));
+    }
+
+    // A delta that did not reach the file would leave a later one vouching for it, so stop appending;
+    // the file's stamp then falls behind and the next load rebuilds it
+    void checkLog() {
+        if (log.is_open() && !log) log.close();
+    }
+
+    // The stamp the file ends on, read from its header and last line only; empty if it cannot match
+    string lastStamp() const {
+        ifstream file(path, ios::binary);
+        string header;
+        if (!getline(file, header) || header.compare(0, tag.size(), tag) != 0) return "";
+        file.clear();
+        file.seekg(0, ios::end);
+        streamoff size = file.tellg();
+        streamoff from = max<streamoff>(0, size - 4096);
+        string tail(size - from, '\0');
+        file.seekg(from);
+        if (!file.read(&tail[0], tail.size()) || tail.empty() || tail.back() != '\n') return "";
+        size_t start = tail.find_last_of('\n', tail.size() - 2);
+        if (start == string::npos && from > 0) return "";
+        string line = tail.substr(start == string::npos ? 0 : start + 1);
+        line.pop_back();
+        if (line.compare(0, 2, "+,") == 0 || line.compare(0, 2, "-,") == 0) return line.substr(line.rfind(',') + 1);
+        return header.substr(tag.size());
+    }
+
+    // Replay the file and return the stamp of its last line; throws on a malformed line
+    string read() {
+        ifstream file(path);
+        string line, stamp;
+        if (!getline(file, line) || line.compare(0, tag.size(), tag) != 0) return "";
+        stamp = line.substr(tag.size());
+        while (getline(file, line)) {
+            vector<string> fields;
+            stringstream ss(line);
+            string field;
+            while (getline(ss, field, ',')) fields.push_back(field);
+            if (line.empty() || line.back() == ',') fields.push_back("");
+            if (fields[0] == "E" && fields.size() == 5) {
+                insert({fields[1], stoi(fields[2]), fields[3], fields[4]});
+            } else if (fields[0] == "+" && fields.size() == 6) {
+                insert({fields[1], stoi(fields[2]), fields[3], fields[4]});
+                stamp = fields[5];
+            } else if (fields[0] == "-" && fields.size() == 3) {
+                drop(fields[1]);
+                stamp = fields[2];
+            } else {
+                throw runtime_error("malformed " + path + " line");
+            }
+        }
+        // A delta torn by a crash cannot end in the full stamp, so it fails the comparison with the store
+        if (stamp.empty() || stamp.find_first_not_of("0123456789") != string::npos) return "";
+        return stamp;
+    }
+};
+
 // Linked list management class for each hospital
 class HospitalLists {
 private:
@@ -56,9 +827,17 @@ private:
     Doctor* doctors_head;
     Appointment* appointments_head;
     string hospital_id;
+    HospitalStore& store;
+    PersonIndex& patient_index;
+    PersonIndex& doctor_index;
+    size_t bytes;                       // Approximate heap footprint of the lists
 
 public:
-    HospitalLists(string id) : patients_head(nullptr), doctors_head(nullptr), appointments_head(nullptr), hospital_id(id) {}
+    HospitalLists(string id, HospitalStore& records, PersonIndex& patients, PersonIndex& doctors)
+        : patients_head(nullptr), doctors_head(nullptr), appointments_head(nullptr), hospital_id(id), store(records),
+          patient_index(patients), doctor_index(doctors), bytes(sizeof(HospitalLists)) {}
+
+    size_t memoryUsage() const { return bytes; }
 
     // Add patient
     bool addPatient(int id, string name, string dob, string gender) {
@@ -68,7 +847,15 @@ public:
         }
         Patient* newPatient = new Patient{id, name, dob, gender, patients_head};
         patients_head = newPatient;
-        savePatients();
+        bytes += sizeof(Patient) + name.size() + dob.size() + gender.size();
+        if (!store.append(hospital_id, HospitalStore::PATIENT, to_string(id) + "," + name + "," + dob + "," + gender)) {
+            patients_head = newPatient->next;
+            bytes -= sizeof(Patient) + name.size() + dob.size() + gender.size();
+            delete newPatient;
+            cout << "Error: Could not save patient " << id << ".\n";
+            return false;
+        }
+        patient_index.add(hospital_id, id, name, dob, store.stamp(HospitalStore::PATIENT));
         return true;
     }
 
@@ -80,7 +867,15 @@ public:
         }
         Doctor* newDoctor = new Doctor{id, name, specialization, doctors_head};
         doctors_head = newDoctor;
-        saveDoctors();
+        bytes += sizeof(Doctor) + name.size() + specialization.size();
+        if (!store.append(hospital_id, HospitalStore::DOCTOR, to_string(id) + "," + name + "," + specialization)) {
+            doctors_head = newDoctor->next;
+            bytes -= sizeof(Doctor) + name.size() + specialization.size();
+            delete newDoctor;
+            cout << "Error: Could not save doctor " << id << ".\n";
+            return false;
+        }
+        doctor_index.add(hospital_id, id, name, specialization, store.stamp(HospitalStore::DOCTOR));
         return true;
     }
 
@@ -100,7 +895,15 @@ public:
         }
         Appointment* newApp = new Appointment{app_id, patient_id, doctor_id, date, appointments_head};
         appointments_head = newApp;
-        saveAppointments();
+        bytes += sizeof(Appointment) + date.size();
+        if (!store.append(hospital_id, HospitalStore::APPOINTMENT,
+                          to_string(app_id) + "," + to_string(patient_id) + "," + to_string(doctor_id) + "," + date)) {
+            appointments_head = newApp->next;
+            bytes -= sizeof(Appointment) + date.size();
+            delete newApp;
+            cout << "Error: Could not save appointment " << app_id << ".\n";
+            return false;
+        }
         return true;
     }
 
@@ -201,49 +1004,9 @@ public:
         return false;
     }
 
-    // Save patients to CSV
-    void savePatients() {
-        ofstream file(hospital_id + "_patients.csv");
-        file << "PatientID,Name,DOB,Gender\n";
-        Patient* current = patients_head;
-        while (current) {
-            file << current->patient_id << "," << current->name << "," << current->dob << "," << current->gender << "\n";
-            current = current->next;
-        }
-        file.close();
-    }
-
-    // Save doctors to CSV
-    void saveDoctors() {
-        ofstream file(hospital_id + "_doctors.csv");
-        file << "DoctorID,Name,Specialization\n";
-        Doctor* current = doctors_head;
-        while (current) {
-            file << current->doctor_id << "," << current->name << "," << current->specialization << "\n";
-            current = current->next;
-        }
-        file.close();
-    }
-
-    // Save appointments to CSV
-    void saveAppointments() {
-        ofstream file(hospital_id + "_appointments.csv");
-        file << "AppointmentID,PatientID,DoctorID,Date\n";
-        Appointment* current = appointments_head;
-        while (current) {
-            file << current->appointment_id << "," << current->patient_id << "," << current->doctor_id << "," << current->appointment_date << "\n";
-            current = current->next;
-        }
-        file.close();
-    }
-
-    // Load patients from CSV
+    // Load patients from the store
     void loadPatients() {
-        ifstream file(hospital_id + "_patients.csv");
-        if (!file.is_open()) return;
-        string line;
-        getline(file, line); // Skip header
-        while (getline(file, line)) {
+        store.forEach(hospital_id, HospitalStore::PATIENT, [this](const string& line) {
             stringstream ss(line);
             Patient* p = new Patient;
             string id;
@@ -254,17 +1017,13 @@ public:
             getline(ss, p->gender);
             p->next = patients_head;
             patients_head = p;
-        }
-        file.close();
+            bytes += sizeof(Patient) + line.size();
+        });
     }
 
-    // Load doctors from CSV
+    // Load doctors from the store
     void loadDoctors() {
-        ifstream file(hospital_id + "_doctors.csv");
-        if (!file.is_open()) return;
-        string line;
-        getline(file, line); // Skip header
-        while (getline(file, line)) {
+        store.forEach(hospital_id, HospitalStore::DOCTOR, [this](const string& line) {
             stringstream ss(line);
             Doctor* d = new Doctor;
             string id;
@@ -274,17 +1033,13 @@ public:
             getline(ss, d->specialization);
             d->next = doctors_head;
             doctors_head = d;
-        }
-        file.close();
+            bytes += sizeof(Doctor) + line.size();
+        });
     }
 
-    // Load appointments from CSV
+    // Load appointments from the store
     void loadAppointments() {
-        ifstream file(hospital_id + "_appointments.csv");
-        if (!file.is_open()) return;
-        string line;
-        getline(file, line); // Skip header
-        while (getline(file, line)) {
+        store.forEach(hospital_id, HospitalStore::APPOINTMENT, [this](const string& line) {
             stringstream ss(line);
             Appointment* a = new Appointment;
             string id, pid, did;
@@ -297,11 +1052,11 @@ public:
             getline(ss, a->appointment_date);
             a->next = appointments_head;
             appointments_head = a;
-        }
-        file.close();
+            bytes += sizeof(Appointment) + line.size();
+        });
     }
 
-    // Destructor to free memory
+    // Destructor frees memory; every record is already in the store
     ~HospitalLists() {
         while (patients_head) {
             Patient* temp = patients_head;
@@ -326,11 +1081,71 @@ class HospitalGraph {
 private:
     map<string, Hospital> hospitals;
     map<string, vector<Edge>> adjList;
+    HospitalStore store;
+    PersonIndex patients;
+    PersonIndex doctors;
+
+    // Loaded HospitalLists, most recently used first; evicted beyond cache_budget bytes
+    struct CachedLists {
+        HospitalLists* lists;
+        list<string>::iterator position;
+    };
+    map<string, CachedLists> cache;
+    list<string> recent;
+    size_t cache_budget;
+
+    // Free least recently used lists until the cache fits, never touching keep; none is ever dirty
+    void evict(const string& keep) {
+        size_t used = 0;
+        for (const auto& entry : cache) used += entry.second.lists->memoryUsage();
+        while (used > cache_budget && recent.size() > 1) {
+            string victim = recent.back();
+            if (victim == keep) break;
+            used -= cache[victim].lists->memoryUsage();
+            delete cache[victim].lists;
+            cache.erase(victim);
+            recent.pop_back();
+        }
+    }
+
+    void dropCached(const string& id) {
+        auto it = cache.find(id);
+        if (it == cache.end()) return;
+        recent.erase(it->second.position);
+        delete it->second.lists;
+        cache.erase(it);
+    }
 
 public:
-    HospitalGraph() {
+    HospitalGraph(size_t cache_bytes = 64 << 20, bool preload = false)
+        : patients("patient_index.csv", "PatientIndex", HospitalStore::PATIENT),
+          doctors("doctor_index.csv", "DoctorIndex", HospitalStore::DOCTOR), cache_budget(cache_bytes) {
+        auto t0 = chrono::steady_clock::now();
+        auto lap = [&t0]() {
+            auto now = chrono::steady_clock::now();
+            double ms = chrono::duration<double, milli>(now - t0).count();
+            t0 = now;
+            return ms;
+        };
         loadHospitals();
+        double hospitals_ms = lap();
         loadConnections();
+        double connections_ms = lap();
+        store.open("hospital_records.store");
+        if (store.isNew()) importLegacyFiles();
+        patients.open(store.stamp(HospitalStore::PATIENT));
+        doctors.open(store.stamp(HospitalStore::DOCTOR));
+        double store_ms = lap();
+        cout << fixed << setprecision(1) << "Loaded " << hospitals.size() << " hospitals: hospitals " << hospitals_ms
+             << " ms, connections " << connections_ms << " ms, record store " << store_ms << " ms\n";
+        if (preload) preloadLists();
+    }
+
+    ~HospitalGraph() {
+        for (auto& entry : cache) delete entry.second.lists;
+        store.checkpoint();
+        patients.save(store.stamp(HospitalStore::PATIENT));
+        doctors.save(store.stamp(HospitalStore::DOCTOR));
     }
 
     // Add hospital
@@ -362,6 +1177,10 @@ public:
             cout << "Error: Hospital ID " << id << " not found.\n";
             return false;
         }
+        if (!store.removeHospital(id)) {
+            cout << "Error: Could not delete the records of hospital " << id << ".\n";
+            return false;
+        }
         hospitals.erase(id);
         adjList.erase(id);
         for (auto& pair : adjList) {
@@ -371,9 +1190,9 @@ public:
                 pair.second.end()
             );
         }
-        remove((id + "_patients.csv").c_str());
-        remove((id + "_doctors.csv").c_str());
-        remove((id + "_appointments.csv").c_str());
+        dropCached(id);
+        patients.removeHospital(id, store.stamp(HospitalStore::PATIENT));
+        doctors.removeHospital(id, store.stamp(HospitalStore::DOCTOR));
         saveHospitals();
         saveConnections();
         return true;
@@ -426,13 +1245,63 @@ public:
         }
     }
 
-    // Get hospital lists
+    // Parse as many hospitals' lists as fit in the cache on a worker pool, then publish them together
+    void preloadLists() {
+        auto t0 = chrono::steady_clock::now();
+        vector<string> ids;
+        uint64_t planned = 0;
+        for (const auto& pair : hospitals) {
+            uint64_t bytes = store.recordBytes(pair.first) * 2; // Parsed lists take roughly twice the text
+            if (cache.count(pair.first) || planned + bytes > cache_budget) continue;
+            planned += bytes;
+            ids.push_back(pair.first);
+        }
+
+        // Workers only read the mapping and fill their own HospitalLists
+        store.mapAll();
+        vector<HospitalLists*> loaded(ids.size(), nullptr);
+        atomic<size_t> next(0);
+        auto work = [&]() {
+            for (size_t i = next++; i < ids.size(); i = next++) {
+                HospitalLists* lists = new HospitalLists(ids[i], store, patients, doctors);
+                lists->loadPatients();
+                lists->loadDoctors();
+                lists->loadAppointments();
+                loaded[i] = lists;
+            }
+        };
+        unsigned threads = max(1u, min<unsigned>(thread::hardware_concurrency(), ids.size()));
+        vector<thread> pool;
+        for (unsigned w = 1; w < threads; ++w) pool.emplace_back(work);
+        work();
+        for (auto& t : pool) t.join();
+        double parse_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            recent.push_back(ids[i]);
+            cache[ids[i]] = {loaded[i], prev(recent.end())};
+        }
+        double publish_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << fixed << setprecision(1) << "Preloaded " << ids.size() << " hospitals on " << threads
+             << " threads: parse " << parse_ms << " ms, publish " << publish_ms << " ms\n";
+    }
+
+    // Get hospital lists, loading them on first access; the graph owns the returned lists
     HospitalLists* getHospitalLists(string id) {
         if (hospitals.find(id) == hospitals.end()) return nullptr;
-        HospitalLists* lists = new HospitalLists(id);
+        auto it = cache.find(id);
+        if (it != cache.end()) {
+            recent.splice(recent.begin(), recent, it->second.position);
+            return it->second.lists;
+        }
+        HospitalLists* lists = new HospitalLists(id, store, patients, doctors);
         lists->loadPatients();
         lists->loadDoctors();
         lists->loadAppointments();
+        recent.push_front(id);
+        cache[id] = {lists, recent.begin()};
+        evict(id);
         return lists;
     }
 
@@ -503,6 +1372,67 @@ public:
         file.close();
     }
 
+    // Copy the per-hospital CSV files of earlier versions into a newly created store
+    void importLegacyFiles() {
+        const pair<const char*, char> kinds[] = {
+            {"_patients.csv", HospitalStore::PATIENT},
+            {"_doctors.csv", HospitalStore::DOCTOR},
+            {"_appointments.csv", HospitalStore::APPOINTMENT}
+        };
+        for (const auto& pair : hospitals) {
+            for (const auto& kind : kinds) {
+                ifstream file(pair.first + kind.first);
+                if (!file.is_open()) continue;
+                string line;
+                getline(file, line); // Skip header
+                while (getline(file, line)) {
+                    if (!line.empty() && !store.append(pair.first, kind.second, line)) {
+                        cout << "Error: Could not import " << pair.first << kind.first << ".\n";
+                        return;
+                    }
+                }
+                file.close();
+            }
+        }
+        store.checkpoint();
+    }
+
+    // Every registration of a patient, by ID if query is numeric and by name otherwise. A name with no
+    // exact match falls back to names starting with it, then to the closest spellings; how says which.
+    vector<PersonIndex::Entry> findPatient(const string& query, string& how) { return findPerson(patients, query, how); }
+
+    // Every registration of a doctor, searched the same way as patients
+    vector<PersonIndex::Entry> findDoctor(const string& query, string& how) { return findPerson(doctors, query, how); }
+
+    vector<PersonIndex::Entry> findPerson(PersonIndex& index, const string& query, string& how) {
+        const size_t limit = 10;
+        how.clear();
+        index.load(store);
+        bool numeric = !query.empty() && all_of(query.begin(), query.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); });
+        if (numeric) {
+            // IDs are ints, so a number beyond that range matches no one
+            errno = 0;
+            long long id = strtoll(query.c_str(), nullptr, 10);
+            if (errno == ERANGE || id > INT_MAX) return {};
+            return index.findById(static_cast<int>(id));
+        }
+        vector<PersonIndex::Entry> found = index.findByName(query);
+        if (!found.empty()) return found;
+        found = index.findByPrefix(query, limit);
+        if (!found.empty()) {
+            how = "Names starting with \"" + query + "\":";
+            return found;
+        }
+        for (auto& match : index.findByNameFuzzy(query, limit)) found.push_back(match.second);
+        if (!found.empty()) how = "No name starts with \"" + query + "\"; closest spellings:";
+        return found;
+    }
+
+    string hospitalName(const string& id) const {
+        auto it = hospitals.find(id);
+        return it == hospitals.end() ? "" : it->second.name;
+    }
+
     // List hospital IDs
     vector<string> getHospitalIDs() {
         vector<string> ids;
@@ -514,8 +1444,16 @@ public:
 };
 
 // Main program
-int main() {
-    HospitalGraph graph;
+int main(int argc, char* argv[]) {
+    // --cache-mb <n> bounds the memory used by loaded hospital lists; --preload fills it at startup
+    size_t cache_mb = 64;
+    bool preload = false;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--cache-mb" && i + 1 < argc) cache_mb = stoul(argv[++i]);
+        else if (arg == "--preload") preload = true;
+    }
+    HospitalGraph graph(cache_mb << 20, preload);
     string current_hospital;
     HospitalLists* current_lists = nullptr;
 
@@ -528,7 +1466,9 @@ int main() {
             cout << "4. Add Hospital Connection\n";
             cout << "5. View Hospital Network\n";
             cout << "6. Select Hospital\n";
-            cout << "7. Exit\n";
+            cout << "7. Find Patient Across Hospitals\n";
+            cout << "8. Find Doctor Across Hospitals\n";
+            cout << "9. Exit\n";
             cout << "Enter choice: ";
         } else {
             cout << "Current Hospital: " << current_hospital << "\n";
@@ -623,8 +1563,63 @@ int main() {
                     }
                     break;
                 }
-                case 7:
-                    delete current_lists;
+                case 7: {
+                    string query;
+                    cout << "Enter Patient ID or Name: ";
+                    getline(cin, query);
+                    string how;
+                    vector<PersonIndex::Entry> found = graph.findPatient(query, how);
+                    if (found.empty()) {
+                        cout << "No matching patient found.\n";
+                        break;
+                    }
+                    if (!how.empty()) cout << "\n" << how;
+                    cout << "\n" << left
+                         << setw(15) << "Hospital ID"
+                         << setw(25) << "Hospital"
+                         << setw(12) << "Patient ID"
+                         << setw(20) << "Name"
+                         << setw(15) << "DOB" << "\n";
+                    cout << string(87, '-') << "\n";
+                    for (const auto& e : found) {
+                        cout << left
+                             << setw(15) << e.hospital_id
+                             << setw(25) << graph.hospitalName(e.hospital_id)
+                             << setw(12) << e.id
+                             << setw(20) << e.name
+                             << setw(15) << e.detail << "\n";
+                    }
+                    break;
+                }
+                case 8: {
+                    string query;
+                    cout << "Enter Doctor ID or Name: ";
+                    getline(cin, query);
+                    string how;
+                    vector<PersonIndex::Entry> found = graph.findDoctor(query, how);
+                    if (found.empty()) {
+                        cout << "No matching doctor found.\n";
+                        break;
+                    }
+                    if (!how.empty()) cout << "\n" << how;
+                    cout << "\n" << left
+                         << setw(15) << "Hospital ID"
+                         << setw(25) << "Hospital"
+                         << setw(12) << "Doctor ID"
+                         << setw(20) << "Name"
+                         << setw(20) << "Specialization" << "\n";
+                    cout << string(92, '-') << "\n";
+                    for (const auto& e : found) {
+                        cout << left
+                             << setw(15) << e.hospital_id
+                             << setw(25) << graph.hospitalName(e.hospital_id)
+                             << setw(12) << e.id
+                             << setw(20) << e.name
+                             << setw(20) << e.detail << "\n";
+                    }
+                    break;
+                }
+                case 9:
                     return 0;
                 default:
                     cout << "Invalid choice. Try again.\n";
@@ -690,12 +1685,10 @@ int main() {
                     current_lists->displayAppointments();
                     break;
                 case 7:
-                    delete current_lists;
                     current_hospital.clear();
                     current_lists = nullptr;
                     break;
                 case 8:
-                    delete current_lists;
                     return 0;
                 default:
                     cout << "Invalid choice. Try again.\n";
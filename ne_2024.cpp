@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 // Structure definitions
 struct Patient {
@@ -26,10 +27,36 @@ struct Appointment {
     struct Appointment* next;
 };
 
+// Name search: a trie over normalized names (lower case, single spaces), one node per letter.
+// A node's children form a linked list sorted by letter, and each node lists the patients and
+// doctors whose name ends there.
+#define NAME_LEN 50
+#define MAX_RESULTS 10
+
+struct NameRef {
+    int is_doctor;
+    int id;
+    const char* name; // The name as registered, in the patient or doctor record
+    struct NameRef* next;
+};
+
+struct TrieNode {
+    char letter;
+    struct TrieNode* children; // First child, lowest letter
+    struct TrieNode* sibling;  // Next child of the same parent
+    struct NameRef* people;
+};
+
+struct NameMatch {
+    int edits;
+    struct NameRef* ref;
+};
+
 // Global pointers to linked lists
 struct Patient* patients = NULL;
 struct Doctor* doctors = NULL;
 struct Appointment* appointments = NULL;
+struct TrieNode nameRoot = {0, NULL, NULL, NULL};
 
 // Function prototypes
 void registerPatient();
@@ -41,6 +68,10 @@ void displayAppointments();
 struct Patient* findPatient(int patient_id);
 struct Doctor* findDoctor(int doctor_id);
 struct Appointment* findAppointment(int appointment_id);
+void normalizeName(const char* name, char* out);
+void indexName(const char* name, int is_doctor, int id);
+void searchByName();
+void freeTrie(struct TrieNode* node);
 void freeLists();
 
 // Function to register a patient
@@ -65,6 +96,7 @@ void registerPatient() {
     
     newPatient->next = patients;
     patients = newPatient;
+    indexName(newPatient->name, 0, newPatient->patient_id);
     printf("Patient registered successfully!\n");
 }
 
@@ -88,6 +120,7 @@ void registerDoctor() {
     
     newDoctor->next = doctors;
     doctors = newDoctor;
+    indexName(newDoctor->name, 1, newDoctor->doctor_id);
     printf("Doctor registered successfully!\n");
 }
 
@@ -213,6 +246,198 @@ void displayAppointments() {
     }
 }
 
+// Function to normalize a name: lower case, no leading, trailing or repeated spaces
+void normalizeName(const char* name, char* out) {
+    int len = 0;
+    for (const char* c = name; *c != '\0' && len < NAME_LEN - 1; c++) {
+        if (*c == ' ' || *c == '\t') {
+            if (len > 0 && out[len - 1] != ' ') {
+                out[len++] = ' ';
+            }
+        } else {
+            out[len++] = tolower((unsigned char)*c);
+        }
+    }
+    if (len > 0 && out[len - 1] == ' ') {
+        len--;
+    }
+    out[len] = '\0';
+}
+
+// Function to find the child of a trie node for a letter, creating it if asked
+struct TrieNode* trieChild(struct TrieNode* parent, char letter, int create) {
+    struct TrieNode** link = &parent->children;
+    while (*link != NULL && (*link)->letter < letter) {
+        link = &(*link)->sibling;
+    }
+    if (*link != NULL && (*link)->letter == letter) {
+        return *link;
+    }
+    if (!create) {
+        return NULL;
+    }
+    struct TrieNode* node = (struct TrieNode*)malloc(sizeof(struct TrieNode));
+    node->letter = letter;
+    node->children = NULL;
+    node->people = NULL;
+    node->sibling = *link;
+    *link = node;
+    return node;
+}
+
+// Function to add a patient or doctor to the name index
+void indexName(const char* name, int is_doctor, int id) {
+    char key[NAME_LEN];
+    normalizeName(name, key);
+    struct TrieNode* node = &nameRoot;
+    for (int i = 0; key[i] != '\0'; i++) {
+        node = trieChild(node, key[i], 1);
+    }
+    struct NameRef* ref = (struct NameRef*)malloc(sizeof(struct NameRef));
+    ref->is_doctor = is_doctor;
+    ref->id = id;
+    ref->name = name;
+    ref->next = node->people;
+    node->people = ref;
+}
+
+// Function to print one search result
+void printNameRef(struct NameRef* ref) {
+    printf("%s\t%d\t%s", ref->is_doctor ? "Doctor" : "Patient", ref->id, ref->name);
+}
+
+// Function to list the names under a trie node in alphabetical order, up to MAX_RESULTS in total
+void listNames(struct TrieNode* node, int* shown) {
+    for (struct NameRef* ref = node->people; ref != NULL && *shown < MAX_RESULTS; ref = ref->next) {
+        printNameRef(ref);
+        printf("\n");
+        (*shown)++;
+    }
+    for (struct TrieNode* child = node->children; child != NULL && *shown < MAX_RESULTS; child = child->sibling) {
+        listNames(child, shown);
+    }
+}
+
+// Function to keep the MAX_RESULTS closest matches, fewest edits first
+void addMatch(struct NameMatch* best, int* count, int edits, struct NameRef* ref) {
+    int i = *count < MAX_RESULTS ? (*count)++ : MAX_RESULTS;
+    while (i > 0 && best[i - 1].edits > edits) {
+        if (i < MAX_RESULTS) {
+            best[i] = best[i - 1];
+        }
+        i--;
+    }
+    if (i < MAX_RESULTS) {
+        best[i].edits = edits;
+        best[i].ref = ref;
+    }
+}
+
+// Function to find names within maxEdits of the query below a trie node. rows[d] holds the edit
+// distances between the first d letters of the path and each prefix of the query; a swap of two
+// adjacent letters counts as one edit. A branch is abandoned once every entry of its row is over
+// maxEdits, since rows further down never get smaller.
+void fuzzyWalk(struct TrieNode* node, int depth, const char* query, int qlen, int rows[][NAME_LEN + 1],
+               char* path, int maxEdits, struct NameMatch* best, int* count) {
+    for (struct TrieNode* child = node->children; child != NULL; child = child->sibling) {
+        int* row = rows[depth + 1];
+        int* above = rows[depth];
+        int smallest = row[0] = depth + 1;
+        for (int j = 1; j <= qlen; j++) {
+            int cost = query[j - 1] == child->letter ? 0 : 1;
+            int d = above[j - 1] + cost;
+            if (above[j] + 1 < d) {
+                d = above[j] + 1;
+            }
+            if (row[j - 1] + 1 < d) {
+                d = row[j - 1] + 1;
+            }
+            if (depth > 0 && j > 1 && query[j - 1] == path[depth - 1] && query[j - 2] == child->letter &&
+                rows[depth - 1][j - 2] + 1 < d) {
+                d = rows[depth - 1][j - 2] + 1;
+            }
+            row[j] = d;
+            if (d < smallest) {
+                smallest = d;
+            }
+        }
+        if (smallest > maxEdits) {
+            continue;
+        }
+        path[depth] = child->letter;
+        if (row[qlen] <= maxEdits) {
+            for (struct NameRef* ref = child->people; ref != NULL; ref = ref->next) {
+                addMatch(best, count, row[qlen], ref);
+            }
+        }
+        if (depth + 1 < NAME_LEN - 1) {
+            fuzzyWalk(child, depth + 1, query, qlen, rows, path, maxEdits, best, count);
+        }
+    }
+}
+
+// Function to search patients and doctors by the start of their name, or by the closest
+// spellings (1 edit, 2 from 8 letters) when no name starts with the query
+void searchByName() {
+    char input[NAME_LEN], query[NAME_LEN];
+    printf("Enter name or start of a name: ");
+    scanf(" %49[^\n]", input);
+    normalizeName(input, query);
+
+    struct TrieNode* node = &nameRoot;
+    for (int i = 0; query[i] != '\0' && node != NULL; i++) {
+        node = trieChild(node, query[i], 0);
+    }
+    if (node != NULL && query[0] != '\0') {
+        int shown = 0;
+        printf("\nNames starting with \"%s\":\n", input);
+        printf("Type\tID\tName\n");
+        printf("------------------------------------------------\n");
+        listNames(node, &shown);
+        return;
+    }
+
+    int qlen = strlen(query);
+    int rows[NAME_LEN + 1][NAME_LEN + 1];
+    char path[NAME_LEN];
+    struct NameMatch best[MAX_RESULTS];
+    int count = 0;
+    for (int j = 0; j <= qlen; j++) {
+        rows[0][j] = j;
+    }
+    fuzzyWalk(&nameRoot, 0, query, qlen, rows, path, qlen >= 8 ? 2 : 1, best, &count);
+    if (count == 0) {
+        printf("No matching name found.\n");
+        return;
+    }
+    printf("\nNo name starts with \"%s\"; closest spellings:\n", input);
+    printf("Type\tID\tName\n");
+    printf("------------------------------------------------\n");
+    for (int i = 0; i < count; i++) {
+        printNameRef(best[i].ref);
+        printf("\t(%d %s)\n", best[i].edits, best[i].edits == 1 ? "edit" : "edits");
+    }
+}
+
+// Function to free the name index below a trie node
+void freeTrie(struct TrieNode* node) {
+    struct TrieNode* child = node->children;
+    while (child != NULL) {
+        struct TrieNode* next = child->sibling;
+        freeTrie(child);
+        free(child);
+        child = next;
+    }
+    struct NameRef* ref = node->people;
+    while (ref != NULL) {
+        struct NameRef* temp = ref;
+        ref = ref->next;
+        free(temp);
+    }
+    node->children = NULL;
+    node->people = NULL;
+}
+
 // Function to free all linked lists
 void freeLists() {
     struct Patient* patient = patients;
@@ -235,6 +460,8 @@ void freeLists() {
         appointment = appointment->next;
         free(temp);
     }
+
+    freeTrie(&nameRoot);
 }
 
 // Main function with menu
@@ -248,7 +475,8 @@ int main() {
         printf("4. Display Patients\n");
         printf("5. Display Doctors\n");
         printf("6. Display Appointments\n");
-        printf("7. Exit\n");
+        printf("7. Search by Name\n");
+        printf("8. Exit\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
         
@@ -272,6 +500,9 @@ int main() {
                 displayAppointments();
                 break;
             case 7:
+                searchByName();
+                break;
+            case 8:
                 freeLists();
                 printf("Exiting program.\n");
                 return 0;
@@ -2,12 +2,26 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <map>
 #include <vector>
 #include <fstream>
 #include <sstream>
 #include <limits>
-#include <algorithm> // std::remove_if
+#include <algorithm> // std::remove_if, std::max
 #include <climits>   // INT_MIN, INT_MAX
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <array>
+#include <tuple>
+#include <cstdint>
+#include <cstdio>    // std::rename, std::remove
+#include <fcntl.h>
+#include <unistd.h>  // write, pread, fsync, ftruncate
 
 using namespace std;
 
@@ -43,6 +57,26 @@ int readInt(const string &prompt, int minVal = INT_MIN, int maxVal = INT_MAX)
     }
 }
 
+// ======== Utility: Normalized Keys ========
+// Lower case with surrounding and repeated spaces removed, so "  Cardiology " matches "cardiology"
+string normalizeKey(const string &s)
+{
+    string out;
+    for (char ch : s)
+    {
+        if (isspace((unsigned char)ch))
+        {
+            if (!out.empty() && out.back() != ' ')
+                out += ' ';
+        }
+        else
+            out += tolower((unsigned char)ch);
+    }
+    if (!out.empty() && out.back() == ' ')
+        out.pop_back();
+    return out;
+}
+
 // ======== Data Structures ========
 struct Patient
 {
@@ -63,6 +97,346 @@ struct Appointment
     Appointment *next;
 };
 
+// ======== Write-Ahead Log ========
+// Registrations are appended here instead of rewriting the CSV files. A committer thread writes
+// everything queued since its last pass with one write and one fsync (group commit), and each
+// caller blocks until its own record is durable. Once the log grows past a threshold the Graph
+// snapshots the changed hospitals to CSV in the background and starts a fresh log.
+// Each line is "<crc32 of the record, 8 hex digits>,<record>", so replay skips torn or damaged records.
+// After a failed write or fsync nothing more is accepted: what reached the disk is unknown until the
+// log is reopened and its tail checked.
+const size_t WAL_SNAPSHOT_BYTES = 1 << 20;
+
+// Make renames in the working directory durable
+bool syncDirectory()
+{
+    int dfd = ::open(".", O_RDONLY);
+    if (dfd == -1)
+        return false;
+    bool ok = fsync(dfd) == 0;
+    close(dfd);
+    return ok;
+}
+
+class WriteAheadLog
+{
+public:
+    explicit WriteAheadLog(const string &path) : path(path)
+    {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        // The log may have just been created, here or by an earlier run that failed before syncing the
+        // directory, and its records are only durable once its directory entry is
+        if (fd != -1 && syncDirectory())
+            bytes = dropTornTail(fd);
+        else
+            failedFrom = 1;
+        committer = thread([this]()
+                           { run(); });
+    }
+    ~WriteAheadLog()
+    {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        work.notify_one();
+        committer.join();
+        if (fd != -1)
+            close(fd);
+    }
+
+    // Append one record and return once it has been fsynced; false if it could not be made durable
+    bool commit(const string &record)
+    {
+        char crc[10];
+        snprintf(crc, sizeof(crc), "%08x,", checksum(record));
+        unique_lock<mutex> lock(m);
+        if (failed())
+            return false;
+        queued += crc + record + "\n";
+        uint64_t ticket = ++appended;
+        work.notify_one();
+        done.wait(lock, [&]()
+                  { return completed >= ticket; });
+        return ticket < failedFrom;
+    }
+
+    size_t size()
+    {
+        lock_guard<mutex> lock(m);
+        return bytes;
+    }
+
+    // Move the current log aside as "<path>.1" and continue in an empty one. Refused while an earlier
+    // rotated log is still waiting for its snapshot, or once the log has failed. If the new log cannot
+    // be created durably the rotation still stands, but the log fails and accepts nothing more.
+    bool rotate()
+    {
+        unique_lock<mutex> lock(m);
+        done.wait(lock, [&]()
+                  { return completed == appended; });
+        if (failed() || access(rotatedPath().c_str(), F_OK) == 0)
+            return false;
+        if (std::rename(path.c_str(), rotatedPath().c_str()) != 0)
+            return false;
+        close(fd);
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        bytes = 0;
+        if (fd == -1 || !syncDirectory())
+            failedFrom = appended + 1;
+        return true;
+    }
+
+    // The rotated log is no longer needed once its records are in a snapshot
+    void removeRotated() { std::remove(rotatedPath().c_str()); }
+
+    string currentPath() const { return path; }
+    string rotatedPath() const { return path + ".1"; }
+
+    // Call apply for every intact record of a log file, in order; returns false if the file is missing
+    static bool replay(const string &file, const function<void(const string &)> &apply)
+    {
+        ifstream f(file);
+        if (!f)
+            return false;
+        string line;
+        while (getline(f, line))
+        {
+            if (line.size() < 9 || line[8] != ',')
+                continue;
+            char *end;
+            unsigned long crc = strtoul(line.substr(0, 8).c_str(), &end, 16);
+            string record = line.substr(9);
+            if (*end == '\0' && crc == checksum(record))
+                apply(record);
+        }
+        return true;
+    }
+
+private:
+    string path;
+    int fd = -1;
+    size_t bytes = 0;
+    mutex m;
+    condition_variable work, done;
+    string queued;
+    uint64_t appended = 0, completed = 0; // Tickets handed out, and tickets whose batch has been written
+    uint64_t failedFrom = numeric_limits<uint64_t>::max(); // First ticket of the batch that failed
+    bool stopping = false;
+    thread committer;
+
+    bool failed() const { return failedFrom != numeric_limits<uint64_t>::max(); }
+
+    // CRC-32 (IEEE 802.3)
+    static uint32_t checksum(const string &s)
+    {
+        static const array<uint32_t, 256> table = []()
+        {
+            array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t c = 0xFFFFFFFFu;
+        for (unsigned char ch : s)
+            c = table[(c ^ ch) & 0xFF] ^ (c >> 8);
+        return c ^ 0xFFFFFFFFu;
+    }
+
+    // Cut the file back to just after its last newline and return the new size. A crash mid-write
+    // leaves a partial final record, and the next record appended would run on from it and be lost
+    // with it on replay.
+    static size_t dropTornTail(int fd)
+    {
+        off_t end = lseek(fd, 0, SEEK_END);
+        if (end <= 0)
+            return 0;
+        off_t keep = end, cut = 0;
+        char buf[4096];
+        while (keep > 0)
+        {
+            off_t from = max<off_t>(0, keep - (off_t)sizeof(buf));
+            if (pread(fd, buf, keep - from, from) != keep - from)
+                return end;
+            const char *nl = find(make_reverse_iterator(buf + (keep - from)), make_reverse_iterator(buf), '\n').base();
+            if (nl != buf)
+            {
+                cut = from + (nl - buf);
+                break;
+            }
+            keep = from;
+        }
+        if (cut < end && ftruncate(fd, cut) != 0)
+            return end;
+        return cut;
+    }
+
+    void run()
+    {
+        unique_lock<mutex> lock(m);
+        while (true)
+        {
+            work.wait(lock, [&]()
+                      { return stopping || !queued.empty(); });
+            if (queued.empty())
+                return;
+            string batch;
+            batch.swap(queued);
+            uint64_t first = completed + 1, last = appended;
+            int out = failed() ? -1 : fd;
+            lock.unlock();
+
+            // Everything that queued up during the previous fsync goes out together
+            size_t written = 0;
+            while (out != -1 && written < batch.size())
+            {
+                ssize_t n = ::write(out, batch.data() + written, batch.size() - written);
+                if (n <= 0)
+                    break;
+                written += n;
+            }
+            bool ok = out != -1 && written == batch.size() && fsync(out) == 0;
+
+            lock.lock();
+            bytes += written;
+            if (!ok)
+                failedFrom = min(failedFrom, first);
+            completed = last;
+            done.notify_all();
+        }
+    }
+};
+
+// ======== Doctor Schedules ========
+// Appointment times are "YYYY-MM-DD HH:MM" and every appointment occupies one fixed slot.
+// Times are kept as minutes since 1970-01-01 so slots compare and step across day boundaries.
+const int SLOT_MINUTES = 30;
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+long long daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Parse "YYYY-MM-DD HH:MM" into minutes; false for anything else, including impossible dates
+bool parseSlot(const string &s, long long &minutes)
+{
+    int y, mo, d, h, mi;
+    char tail;
+    if (sscanf(s.c_str(), "%d-%d-%d %d:%d %c", &y, &mo, &d, &h, &mi, &tail) != 5)
+        return false;
+    if (mo < 1 || mo > 12 || d < 1 || h < 0 || h > 23 || mi < 0 || mi > 59)
+        return false;
+    int monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    if (d > monthDays[mo - 1] + (mo == 2 && leap))
+        return false;
+    minutes = daysFromCivil(y, mo, d) * 1440 + h * 60 + mi;
+    return true;
+}
+
+// Parse "YYYY-MM-DD" into the minute the day starts at
+bool parseDay(const string &s, long long &minutes)
+{
+    return parseSlot(s + " 00:00", minutes);
+}
+
+string formatSlot(long long minutes)
+{
+    long long z = minutes / 1440 + 719468;
+    if (minutes % 1440 < 0)
+        --z;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    int d = doy - (153 * mp + 2) / 5 + 1;
+    int m = mp < 10 ? mp + 3 : mp - 9;
+    long long y = yoe + era * 400 + (m <= 2);
+    int minuteOfDay = ((minutes % 1440) + 1440) % 1440;
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%04lld-%02d-%02d %02d:%02d", y, m, d, minuteOfDay / 60, minuteOfDay % 60);
+    return buf;
+}
+
+// One doctor's bookings, ordered by start time, plus the same time coalesced into busy blocks.
+// Appointments are never removed, so a block only grows or merges with its neighbours.
+class DoctorSchedule
+{
+public:
+    map<long long, const Appointment *> bookings; // Slot start -> appointment, owned by the hospital's list
+    map<long long, long long> busy; // Block start -> block end (exclusive), non-overlapping
+
+    // Does [start, start + SLOT_MINUTES) overlap an existing booking?
+    bool conflicts(long long start) const
+    {
+        auto it = bookings.lower_bound(start - SLOT_MINUTES + 1);
+        return it != bookings.end() && it->first < start + SLOT_MINUTES;
+    }
+
+    void book(long long start, const Appointment *a)
+    {
+        bookings[start] = a;
+        long long s = start, e = start + SLOT_MINUTES;
+        auto it = busy.upper_bound(s);
+        if (it != busy.begin() && prev(it)->second >= s)
+            --it;
+        while (it != busy.end() && it->first <= e)
+        {
+            s = min(s, it->first);
+            e = max(e, it->second);
+            it = busy.erase(it);
+        }
+        busy[s] = e;
+    }
+
+    // Earliest start at or after from whose whole slot is free; only gaps too short for a slot are skipped
+    long long nextFree(long long from) const
+    {
+        long long t = from;
+        auto it = busy.upper_bound(t);
+        if (it != busy.begin() && prev(it)->second > t)
+            t = prev(it)->second;
+        while (it != busy.end() && it->first < t + SLOT_MINUTES)
+        {
+            t = max(t, it->second);
+            ++it;
+        }
+        return t;
+    }
+
+    // Undo a booking; the busy blocks are rebuilt from the remaining bookings
+    void cancel(long long start)
+    {
+        bookings.erase(start);
+        busy.clear();
+        map<long long, const Appointment *> kept;
+        kept.swap(bookings);
+        for (auto &b : kept)
+            book(b.first, b.second);
+    }
+
+    // Bookings that start within [from, to)
+    vector<pair<long long, const Appointment *>> between(long long from, long long to) const
+    {
+        vector<pair<long long, const Appointment *>> out;
+        for (auto it = bookings.lower_bound(from); it != bookings.end() && it->first < to; ++it)
+            out.push_back(*it);
+        return out;
+    }
+};
+
 // ======== Hospital Class ========
 class Hospital
 {
@@ -76,146 +450,915 @@ public:
     int nextDoctorId = 1;
     int nextAppointmentId = 1;
 
+    unordered_map<int, DoctorSchedule> schedules; // Doctor ID -> bookings with a parsed time
+
+    WriteAheadLog *wal = nullptr;
+    bool logged = false; // Has records in the log that are not yet in a snapshot
+
+    // Copy of the lists, written to CSV off the registration path
+    struct Snapshot
+    {
+        string hospitalId;
+        vector<Patient> patients;
+        vector<Doctor> doctors;
+        vector<Appointment> appointments;
+    };
+
     Hospital() = default;
     Hospital(const string &id, const string &nm, const string &loc)
         : hospitalId(id), name(nm), location(loc)
     {
         loadData();
         normalizeCounters();
+        for (auto *a = appointments; a; a = a->next)
+            indexAppointment(*a);
     }
 
     int registerPatient(const string &n, const string &d, const string &g)
     {
         int id = nextPatientId++;
         patients = new Patient{id, n, d, g, patients};
-        saveData();
+        if (!logRecord("P," + to_string(id) + ',' + n + ',' + d + ',' + g))
+        {
+            dropHead(patients);
+            --nextPatientId;
+            return -1;
+        }
         return id;
     }
+    // Both return the new ID, or -1 if the registration could not be saved
     int registerDoctor(const string &n, const string &spec)
     {
         int id = nextDoctorId++;
         doctors = new Doctor{id, n, spec, doctors};
-        saveData();
+        if (!logRecord("D," + to_string(id) + ',' + n + ',' + spec))
+        {
+            dropHead(doctors);
+            --nextDoctorId;
+            return -1;
+        }
         return id;
     }
+    // Returns the new ID, -1 for unknown IDs, -2 for a malformed time, -3 if the doctor is already booked,
+    // -4 if the registration could not be saved
     int registerAppointment(int pid, int did, const string &dt)
     {
         if (!findPatient(pid) || !findDoctor(did))
             return -1;
+        long long start;
+        if (!parseSlot(dt, start))
+            return -2;
+        if (schedules[did].conflicts(start))
+            return -3;
         int id = nextAppointmentId++;
         appointments = new Appointment{id, pid, did, dt, appointments};
-        saveData();
+        schedules[did].book(start, appointments);
+        if (!logRecord("A," + to_string(id) + ',' + to_string(pid) + ',' + to_string(did) + ',' + dt))
+        {
+            schedules[did].cancel(start);
+            dropHead(appointments);
+            --nextAppointmentId;
+            return -4;
+        }
+        return id;
+    }
+
+    // Re-apply a logged registration (type, then the CSV columns); records already present are skipped.
+    // IDs are handed out and logged in order, so one below the counter is already in the lists from a
+    // snapshot that covered it, and no list has to be searched.
+    void applyRecord(char type, const vector<string> &cols)
+    {
+        if (type == 'P' && cols.size() >= 4 && stoi(cols[0]) >= nextPatientId)
+        {
+            patients = new Patient{stoi(cols[0]), cols[1], cols[2], cols[3], patients};
+            nextPatientId = max(nextPatientId, patients->id + 1);
+        }
+        else if (type == 'D' && cols.size() >= 3 && stoi(cols[0]) >= nextDoctorId)
+        {
+            doctors = new Doctor{stoi(cols[0]), cols[1], cols[2], doctors};
+            nextDoctorId = max(nextDoctorId, doctors->id + 1);
+        }
+        else if (type == 'A' && cols.size() >= 4 && stoi(cols[0]) >= nextAppointmentId)
+        {
+            appointments = new Appointment{stoi(cols[0]), stoi(cols[1]), stoi(cols[2]), cols[3], appointments};
+            nextAppointmentId = max(nextAppointmentId, appointments->id + 1);
+            indexAppointment(*appointments);
+        }
+        logged = true;
+    }
+
+    void displayPatients()
+    {
+        cout << "-- Patients in " << name << " (" << hospitalId << ") --\n";
+        for (auto *p = patients; p; p = p->next)
+            cout << p->id << ": " << p->name << " | " << p->dob << " | " << p->gender << "\n";
+    }
+    void displayDoctors()
+    {
+        cout << "-- Doctors in " << name << " (" << hospitalId << ") --\n";
+        for (auto *d = doctors; d; d = d->next)
+            cout << d->id << ": " << d->name << " | " << d->specialization << "\n";
+    }
+    void displayAppointments()
+    {
+        cout << "-- Appointments in " << name << " (" << hospitalId << ") --\n";
+        for (auto *a = appointments; a; a = a->next)
+            cout << a->id << ": P" << a->patientId << " → D" << a->doctorId << " on " << a->date << "\n";
+    }
+
+    // Earliest free slot for a doctor at or after a time; -1 for an unknown doctor
+    long long nextFreeSlot(int did, long long from)
+    {
+        if (!findDoctor(did))
+            return -1;
+        auto it = schedules.find(did);
+        return it == schedules.end() ? from : it->second.nextFree(from);
+    }
+    void displayDaySchedule(int did, long long day)
+    {
+        cout << "-- Schedule of D" << did << " on " << formatSlot(day).substr(0, 10) << " --\n";
+        auto it = schedules.find(did);
+        if (it == schedules.end())
+            return;
+        for (auto &slot : it->second.between(day, day + 1440))
+            cout << formatSlot(slot.first).substr(11) << "-" << formatSlot(slot.first + SLOT_MINUTES).substr(11)
+                 << " | appointment " << slot.second->id << " | P" << slot.second->patientId << "\n";
+    }
+
+    void loadData()
+    {
+        loadList<Patient>(hospitalId + "_patients.csv", patients);
+        loadList<Doctor>(hospitalId + "_doctors.csv", doctors);
+        loadList<Appointment>(hospitalId + "_appointments.csv", appointments);
+    }
+    Snapshot snapshot() const
+    {
+        Snapshot snap{hospitalId, {}, {}, {}};
+        for (auto *p = patients; p; p = p->next)
+            snap.patients.push_back(*p);
+        for (auto *d = doctors; d; d = d->next)
+            snap.doctors.push_back(*d);
+        for (auto *a = appointments; a; a = a->next)
+            snap.appointments.push_back(*a);
+        return snap;
+    }
+
+    // Write a snapshot's three CSV files; each replaces the old one only once it is on disk.
+    // False if any of them could not be written; the renames still need a directory fsync.
+    static bool saveSnapshot(const Snapshot &snap)
+    {
+        string out = "id,name,dob,gender\n";
+        for (auto &p : snap.patients)
+            out += to_string(p.id) + ',' + p.name + ',' + p.dob + ',' + p.gender + "\n";
+        bool ok = writeDurably(snap.hospitalId + "_patients.csv", out);
+
+        out = "id,name,specialization\n";
+        for (auto &d : snap.doctors)
+            out += to_string(d.id) + ',' + d.name + ',' + d.specialization + "\n";
+        ok = writeDurably(snap.hospitalId + "_doctors.csv", out) && ok;
+
+        out = "id,patientId,doctorId,date\n";
+        for (auto &a : snap.appointments)
+            out += to_string(a.id) + ',' + to_string(a.patientId) + ',' + to_string(a.doctorId) + ',' + a.date + "\n";
+        return writeDurably(snap.hospitalId + "_appointments.csv", out) && ok;
+    }
+
+private:
+    // Make a registration already applied in memory durable; false if it could not be saved
+    bool logRecord(const string &record)
+    {
+        bool ok = wal ? wal->commit(record.substr(0, 2) + hospitalId + ',' + record.substr(2))
+                      : saveSnapshot(snapshot()) && syncDirectory();
+        if (ok)
+            logged = true;
+        return ok;
+    }
+
+    static bool writeDurably(const string &fn, const string &content)
+    {
+        string tmp = fn + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+            return false;
+        size_t written = 0;
+        while (written < content.size())
+        {
+            ssize_t n = ::write(fd, content.data() + written, content.size() - written);
+            if (n <= 0)
+                break;
+            written += n;
+        }
+        bool ok = written == content.size() && fsync(fd) == 0;
+        ok = close(fd) == 0 && ok;
+        if (!ok)
+        {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return std::rename(tmp.c_str(), fn.c_str()) == 0;
+    }
+
+    template <typename T>
+    static void dropHead(T *&head)
+    {
+        T *node = head;
+        head = node->next;
+        delete node;
+    }
+
+    Patient *findPatient(int id)
+    {
+        for (auto *p = patients; p; p = p->next)
+            if (p->id == id)
+                return p;
+        return nullptr;
+    }
+    Doctor *findDoctor(int id)
+    {
+        for (auto *d = doctors; d; d = d->next)
+            if (d->id == id)
+                return d;
+        return nullptr;
+    }
+    Appointment *findAppointment(int id)
+    {
+        for (auto *a = appointments; a; a = a->next)
+            if (a->id == id)
+                return a;
+        return nullptr;
+    }
+
+    // Appointments saved before times were required keep their free-form date and are not indexed
+    void indexAppointment(const Appointment &a)
+    {
+        long long start;
+        if (parseSlot(a.date, start))
+            schedules[a.doctorId].book(start, &a);
+    }
+
+    template <typename T>
+    void loadList(const string &fn, T *&head)
+    {
+        ifstream f(fn);
+        if (!f)
+            return;
+        string line;
+        getline(f, line);
+        while (getline(f, line))
+        {
+            stringstream ss(line);
+            vector<string> cols;
+            string tok;
+            while (getline(ss, tok, ','))
+                cols.push_back(tok);
+            if constexpr (is_same<T, Patient>::value)
+            {
+                head = new Patient{stoi(cols[0]), cols[1], cols[2], cols[3], head};
+            }
+            else if constexpr (is_same<T, Doctor>::value)
+            {
+                head = new Doctor{stoi(cols[0]), cols[1], cols[2], head};
+            }
+            else
+            {
+                head = new Appointment{stoi(cols[0]), stoi(cols[1]), stoi(cols[2]), cols[3], head};
+            }
+        }
+    }
+
+    void normalizeCounters()
+    {
+        for (auto *p = patients; p; p = p->next)
+            nextPatientId = max(nextPatientId, p->id + 1);
+        for (auto *d = doctors; d; d = d->next)
+            nextDoctorId = max(nextDoctorId, d->id + 1);
+        for (auto *a = appointments; a; a = a->next)
+            nextAppointmentId = max(nextAppointmentId, a->id + 1);
+    }
+};
+
+// ======== Adjacency ========
+// Hospital IDs are interned to dense integers once, and each node keeps a hash map from neighbour
+// to distance, so membership, update and removal of an edge are O(1) regardless of hub degree.
+// Lookups never create entries; only intern() and connect() grow the structure.
+class Adjacency
+{
+public:
+    int intern(const string &id)
+    {
+        auto it = index.find(id);
+        if (it != index.end())
+            return it->second;
+        index[id] = names.size();
+        names.push_back(id);
+        edges.emplace_back();
+        return names.size() - 1;
+    }
+    int find(const string &id) const
+    {
+        auto it = index.find(id);
+        return it == index.end() ? -1 : it->second;
+    }
+    const string &name(int v) const { return names[v]; }
+    size_t size() const { return names.size(); }
+
+    const unordered_map<int, int> &neighbours(int v) const { return edges[v]; }
+    bool connected(int a, int b) const { return edges[a].count(b) > 0; }
+
+    // Distance of an existing edge, or nullptr
+    int *distance(int a, int b)
+    {
+        auto it = edges[a].find(b);
+        return it == edges[a].end() ? nullptr : &it->second;
+    }
+    void connect(int a, int b, int d)
+    {
+        edges[a][b] = d;
+        edges[b][a] = d;
+    }
+    bool disconnect(int a, int b)
+    {
+        edges[b].erase(a);
+        return edges[a].erase(b) > 0;
+    }
+    // Drop every edge of v; touches only v's neighbours
+    void isolate(int v)
+    {
+        for (auto &e : edges[v])
+            edges[e.first].erase(v);
+        edges[v].clear();
+    }
+
+private:
+    unordered_map<string, int> index;
+    vector<string> names;
+    vector<unordered_map<int, int>> edges;
+};
+
+// ======== Specialization Index ========
+// Normalized specialization -> the doctors who have it, across all hospitals. Specializations are
+// interned to small integers; each posting names the hospital by its interned graph index and
+// points at the doctor's list node, so a query reads only the postings for that specialization.
+class SpecializationIndex
+{
+public:
+    struct Posting
+    {
+        int hospital;
+        const Doctor *doctor;
+    };
+
+    void add(int hospital, const Doctor *doctor)
+    {
+        string key = normalizeKey(doctor->specialization);
+        auto it = ids.find(key);
+        int spec = it != ids.end() ? it->second : intern(key);
+        postings[spec].push_back({hospital, doctor});
+        specsOf[hospital].insert(spec);
+    }
+
+    // Drop a deleted hospital's postings; only the specializations it had are visited
+    void removeHospital(int hospital)
+    {
+        auto it = specsOf.find(hospital);
+        if (it == specsOf.end())
+            return;
+        for (int spec : it->second)
+        {
+            auto &list = postings[spec];
+            list.erase(remove_if(list.begin(), list.end(),
+                                 [&](const Posting &p)
+                                 { return p.hospital == hospital; }),
+                       list.end());
+        }
+        specsOf.erase(it);
+    }
+
+    const vector<Posting> &find(const string &spec) const
+    {
+        static const vector<Posting> none;
+        auto it = ids.find(normalizeKey(spec));
+        return it == ids.end() ? none : postings[it->second];
+    }
+
+private:
+    unordered_map<string, int> ids;
+    vector<vector<Posting>> postings;
+    unordered_map<int, unordered_set<int>> specsOf; // Hospital -> specialization IDs its doctors have
+
+    int intern(const string &key)
+    {
+        ids[key] = postings.size();
+        postings.emplace_back();
+        return postings.size() - 1;
+    }
+};
+
+// ======== Name Search ========
+// Patients and doctors of every hospital by normalized name. Names are split into words, and
+// every distinct word is stored once however many people share it, so the search structures
+// grow with the vocabulary rather than the number of people. A radix trie over the words answers
+// typeahead: the last word typed is a prefix, the words before it must match whole. Misspellings
+// go through a trigram index over the same words: words sharing enough trigrams with a query
+// word are checked with a bounded edit distance.
+class NameIndex
+{
+public:
+    struct Entry
+    {
+        int hospital; // Interned graph index
+        int id;
+        bool doctor;
+        const string *name; // The name as registered, in the patient or doctor node
+    };
+
+    void add(int hospital, int id, bool doctor, const string &name)
+    {
+        string norm = normalizeKey(name);
+        if (norm.empty())
+            return;
+        auto it = nameIds.find(norm);
+        int nameId;
+        if (it != nameIds.end())
+            nameId = it->second;
+        else
+        {
+            nameId = entries.size();
+            nameIds[norm] = nameId;
+            entries.emplace_back();
+            nameWords.emplace_back();
+            for (auto &w : split(norm))
+            {
+                int wordId = internWord(w);
+                if (find(nameWords[nameId].begin(), nameWords[nameId].end(), wordId) == nameWords[nameId].end())
+                {
+                    nameWords[nameId].push_back(wordId);
+                    wordNames[wordId].push_back(nameId);
+                }
+            }
+        }
+        entries[nameId].push_back({hospital, id, doctor, &name});
+        namesOf[hospital].push_back(nameId);
+    }
+
+    // Drop a deleted hospital's people; words stay, and names left without entries are skipped
+    void removeHospital(int hospital)
+    {
+        auto it = namesOf.find(hospital);
+        if (it == namesOf.end())
+            return;
+        for (int nameId : it->second)
+        {
+            auto &list = entries[nameId];
+            list.erase(remove_if(list.begin(), list.end(),
+                                 [&](const Entry &e)
+                                 { return e.hospital == hospital; }),
+                       list.end());
+        }
+        namesOf.erase(it);
+    }
+
+    // Up to limit people with every whole word of the query in their name and a word starting
+    // with its last word. A single word lists names in the order of the matching words.
+    vector<Entry> prefix(const string &query, size_t limit) const
+    {
+        vector<Entry> out;
+        vector<string> q = split(normalizeKey(query));
+        if (q.empty())
+            return out;
+        int v = prefixNode(q.back());
+        if (v < 0)
+            return out;
+
+        unordered_set<int> seen; // A name with two words under the prefix is listed once
+        auto take = [&](int nameId)
+        {
+            if (seen.insert(nameId).second)
+                for (auto &e : entries[nameId])
+                    if (out.size() < limit)
+                        out.push_back(e);
+        };
+
+        if (q.size() == 1)
+        {
+            vector<int> stack{v};
+            while (!stack.empty() && out.size() < limit)
+            {
+                int n = stack.back();
+                stack.pop_back();
+                if (trie[n].word >= 0)
+                    for (int nameId : wordNames[trie[n].word])
+                        if (out.size() < limit)
+                            take(nameId);
+                for (auto c = trie[n].children.rbegin(); c != trie[n].children.rend(); ++c)
+                    stack.push_back(c->second);
+            }
+            return out;
+        }
+
+        // Walk the names of the rarest whole word and keep those that have the others too
+        vector<int> whole;
+        for (size_t i = 0; i + 1 < q.size(); ++i)
+        {
+            auto it = wordIds.find(q[i]);
+            if (it == wordIds.end())
+                return out;
+            whole.push_back(it->second);
+        }
+        int rarest = *min_element(whole.begin(), whole.end(), [&](int a, int b)
+                                  { return wordNames[a].size() < wordNames[b].size(); });
+        for (int nameId : wordNames[rarest])
+        {
+            if (out.size() >= limit)
+                break;
+            const auto &ws = nameWords[nameId];
+            bool ok = all_of(whole.begin(), whole.end(), [&](int w)
+                             { return find(ws.begin(), ws.end(), w) != ws.end(); });
+            ok = ok && any_of(ws.begin(), ws.end(), [&](int w)
+                              { return words[w].compare(0, q.back().size(), q.back()) == 0 &&
+                                       find(whole.begin(), whole.end(), w) == whole.end(); });
+            if (ok)
+                take(nameId);
+        }
+        return out;
+    }
+
+    // Up to limit people whose name has, for every word of the query, a word within a small edit
+    // distance of it (1 edit, 2 from 8 letters; words under 3 letters must match exactly), fewest
+    // total edits first, paired with that total
+    vector<pair<int, Entry>> fuzzy(const string &query, size_t limit)
+    {
+        vector<pair<int, Entry>> out;
+        vector<string> q = split(normalizeKey(query));
+        if (q.empty())
+            return out;
+
+        // Close words for each query word, as word ID -> edits
+        vector<unordered_map<int, int>> close(q.size());
+        for (size_t i = 0; i < q.size(); ++i)
+        {
+            closeWords(q[i], close[i]);
+            if (close[i].empty())
+                return out;
+        }
+
+        // Candidate names come from the query word whose close words are shared by the fewest
+        size_t pivot = 0, fewest = SIZE_MAX;
+        for (size_t i = 0; i < q.size(); ++i)
+        {
+            size_t n = 0;
+            for (auto &c : close[i])
+                n += wordNames[c.first].size();
+            if (n < fewest)
+            {
+                fewest = n;
+                pivot = i;
+            }
+        }
+        vector<pair<int, int>> byEdits(close[pivot].begin(), close[pivot].end());
+        sort(byEdits.begin(), byEdits.end(), [&](const pair<int, int> &a, const pair<int, int> &b)
+             { return a.second != b.second ? a.second < b.second : words[a.first] < words[b.first]; });
+
+        vector<pair<int, int>> found; // (total edits, name ID)
+        unordered_set<int> seen;
+        for (size_t j = 0; j < byEdits.size(); ++j)
+        {
+            // Stop after a whole edit level once enough people are found
+            if (j > 0 && byEdits[j].second != byEdits[j - 1].second && found.size() >= limit)
+                break;
+            for (int nameId : wordNames[byEdits[j].first])
+            {
+                if (entries[nameId].empty() || !seen.insert(nameId).second)
+                    continue;
+                int total = 0;
+                for (size_t i = 0; i < q.size() && total >= 0; ++i)
+                {
+                    int best = -1;
+                    for (int w : nameWords[nameId])
+                    {
+                        auto it = close[i].find(w);
+                        if (it != close[i].end() && (best < 0 || it->second < best))
+                            best = it->second;
+                    }
+                    total = best < 0 ? -1 : total + best;
+                }
+                if (total >= 0)
+                    found.push_back({total, nameId});
+            }
+        }
+        sort(found.begin(), found.end());
+        for (auto &f : found)
+            for (auto &e : entries[f.second])
+                if (out.size() < limit)
+                    out.push_back({f.first, e});
+        return out;
+    }
+
+private:
+    struct Node
+    {
+        string label;                     // Edge label from the parent
+        vector<pair<char, int>> children; // First character of the child's label, child; ordered
+        int word = -1;
+    };
+    vector<Node> trie{1};
+    unordered_map<string, int> nameIds;          // Normalized name -> name ID
+    vector<vector<Entry>> entries;               // Name ID -> people with that name
+    vector<vector<int>> nameWords;               // Name ID -> its distinct word IDs
+    unordered_map<string, int> wordIds;
+    vector<string> words;
+    vector<vector<int>> wordNames;               // Word ID -> names containing it
+    unordered_map<uint64_t, vector<int>> grams;  // (trigram, word length) -> word IDs, once per word
+    unordered_map<int, vector<int>> namesOf;     // Hospital -> name IDs, repeated per person
+    vector<unsigned> hits, stamp;                // Fuzzy query scratch; hits[w] is current iff stamp[w] == epoch
+    unsigned epoch = 0;
+
+    // Words of a normalized name, which has single spaces only
+    static vector<string> split(const string &norm)
+    {
+        vector<string> out;
+        for (size_t i = 0, j; i < norm.size(); i = j + 1)
+        {
+            j = norm.find(' ', i);
+            if (j == string::npos)
+                j = norm.size();
+            out.push_back(norm.substr(i, j - i));
+        }
+        return out;
+    }
+
+    int internWord(const string &w)
+    {
+        auto it = wordIds.find(w);
+        if (it != wordIds.end())
+            return it->second;
+        int id = words.size();
+        wordIds[w] = id;
+        words.push_back(w);
+        wordNames.emplace_back();
+        for (uint32_t g : trigrams(w))
+            grams[gramKey(g, w.size())].push_back(id);
+        insert(w, id);
         return id;
     }
 
-    void displayPatients()
+    // Words within the edit bound of w, found through the trigram lists of similar lengths
+    void closeWords(const string &w, unordered_map<int, int> &out)
     {
-        cout << "-- Patients in " << name << " (" << hospitalId << ") --\n";
-        for (auto *p = patients; p; p = p->next)
-            cout << p->id << ": " << p->name << " | " << p->dob << " | " << p->gender << "\n";
+        if (w.size() < 3)
+        {
+            auto it = wordIds.find(w); // Too short for trigrams to say anything
+            if (it != wordIds.end())
+                out[it->second] = 0;
+            return;
+        }
+        int maxEdits = w.size() >= 8 ? 2 : 1;
+        // Each edit changes at most three of the word's trigrams, a swap of adjacent letters four
+        vector<uint32_t> wgrams = trigrams(w);
+        int need = (int)wgrams.size() - 4 * maxEdits;
+        if (need <= 0)
+        {
+            // A word this short can be one swap from a word sharing none of its trigrams ("abc", "bac"),
+            // which the lists below never reach; swaps are the only such edit, so look them up directly
+            for (size_t i = 0; i + 1 < w.size(); ++i)
+            {
+                string swapped = w;
+                swap(swapped[i], swapped[i + 1]);
+                auto it = wordIds.find(swapped);
+                if (it != wordIds.end() && swapped != w)
+                    out[it->second] = 1;
+            }
+        }
+        if (hits.size() < words.size())
+        {
+            hits.resize(words.size());
+            stamp.resize(words.size(), 0);
+        }
+        if (++epoch == 0)
+        {
+            fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+        vector<int> touched;
+        for (uint32_t g : wgrams)
+        {
+            for (size_t len = w.size() - maxEdits; len <= w.size() + maxEdits; ++len)
+            {
+                auto it = grams.find(gramKey(g, len));
+                if (it == grams.end())
+                    continue;
+                for (int k : it->second)
+                {
+                    if (stamp[k] != epoch)
+                    {
+                        stamp[k] = epoch;
+                        hits[k] = 0;
+                        touched.push_back(k);
+                    }
+                    ++hits[k];
+                }
+            }
+        }
+        for (int k : touched)
+        {
+            if ((int)hits[k] < need)
+                continue;
+            int d = editDistance(w, words[k], maxEdits);
+            if (d <= maxEdits)
+                out[k] = d;
+        }
     }
-    void displayDoctors()
+
+    // The trie node under which every word starting with p lies, or -1
+    int prefixNode(const string &p) const
     {
-        cout << "-- Doctors in " << name << " (" << hospitalId << ") --\n";
-        for (auto *d = doctors; d; d = d->next)
-            cout << d->id << ": " << d->name << " | " << d->specialization << "\n";
+        int v = 0;
+        size_t i = 0;
+        while (i < p.size())
+        {
+            int c = child(v, p[i]);
+            if (c < 0)
+                return -1;
+            const string &label = trie[c].label;
+            size_t l = common(label, p, i);
+            if (i + l < p.size() && l < label.size())
+                return -1;
+            v = c;
+            i += l;
+        }
+        return v;
     }
-    void displayAppointments()
+
+    void insert(const string &w, int id)
     {
-        cout << "-- Appointments in " << name << " (" << hospitalId << ") --\n";
-        for (auto *a = appointments; a; a = a->next)
-            cout << a->id << ": P" << a->patientId << " → D" << a->doctorId << " on " << a->date << "\n";
+        int v = 0;
+        size_t i = 0;
+        while (i < w.size())
+        {
+            int c = child(v, w[i]);
+            if (c < 0)
+            {
+                int n = trie.size();
+                trie.push_back({w.substr(i), {}, id});
+                attach(v, n);
+                return;
+            }
+            size_t l = common(trie[c].label, w, i);
+            if (l < trie[c].label.size())
+            {
+                // Split the edge: the shared part becomes a new node above the old child
+                int mid = trie.size();
+                trie.push_back({trie[c].label.substr(0, l), {{trie[c].label[l], c}}, -1});
+                trie[c].label.erase(0, l);
+                for (auto &ch : trie[v].children)
+                    if (ch.second == c)
+                        ch.second = mid;
+                c = mid;
+            }
+            v = c;
+            i += l;
+        }
+        trie[v].word = id;
     }
 
-    void loadData()
+    // The first characters sit in the parent, so finding a child reads no other node
+    int child(int v, char ch) const
     {
-        loadList<Patient>(hospitalId + "_patients.csv", patients);
-        loadList<Doctor>(hospitalId + "_doctors.csv", doctors);
-        loadList<Appointment>(hospitalId + "_appointments.csv", appointments);
+        for (auto &c : trie[v].children)
+            if (c.first == ch)
+                return c.second;
+        return -1;
     }
-    void saveData()
+    void attach(int v, int c)
     {
-        savePatients(hospitalId + "_patients.csv");
-        saveDoctors(hospitalId + "_doctors.csv");
-        saveAppointments(hospitalId + "_appointments.csv");
+        auto &ch = trie[v].children;
+        pair<char, int> entry{trie[c].label[0], c};
+        ch.insert(upper_bound(ch.begin(), ch.end(), entry), entry);
     }
-
-private:
-    Patient *findPatient(int id)
+    // Length of the common prefix of label and s from position i
+    static size_t common(const string &label, const string &s, size_t i)
     {
-        for (auto *p = patients; p; p = p->next)
-            if (p->id == id)
-                return p;
-        return nullptr;
+        size_t l = 0;
+        while (l < label.size() && i + l < s.size() && label[l] == s[i + l])
+            ++l;
+        return l;
     }
-    Doctor *findDoctor(int id)
+
+    static uint64_t gramKey(uint32_t gram, size_t length) { return (uint64_t)length << 24 | gram; }
+
+    // Distinct trigrams of the word padded as "$$word$", packed into integers
+    static vector<uint32_t> trigrams(const string &w)
     {
-        for (auto *d = doctors; d; d = d->next)
-            if (d->id == id)
-                return d;
-        return nullptr;
+        string padded = "$$" + w + "$";
+        vector<uint32_t> out;
+        for (size_t i = 0; i + 3 <= padded.size(); ++i)
+            out.push_back((uint8_t)padded[i] << 16 | (uint8_t)padded[i + 1] << 8 | (uint8_t)padded[i + 2]);
+        sort(out.begin(), out.end());
+        out.erase(unique(out.begin(), out.end()), out.end());
+        return out;
     }
 
-    template <typename T>
-    void loadList(const string &fn, T *&head)
+    // Edit distance counting a swap of adjacent letters as one edit, or bound + 1 as soon as it
+    // must exceed bound
+    static int editDistance(const string &a, const string &b, int bound)
     {
-        ifstream f(fn);
-        if (!f)
-            return;
-        string line;
-        getline(f, line);
-        while (getline(f, line))
+        vector<int> before(b.size() + 1), prev(b.size() + 1), cur(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j)
+            prev[j] = j;
+        for (size_t i = 1; i <= a.size(); ++i)
         {
-            stringstream ss(line);
-            vector<string> cols;
-            string tok;
-            while (getline(ss, tok, ','))
-                cols.push_back(tok);
-            if constexpr (is_same<T, Patient>::value)
-            {
-                head = new Patient{stoi(cols[0]), cols[1], cols[2], cols[3], head};
-            }
-            else if constexpr (is_same<T, Doctor>::value)
-            {
-                head = new Doctor{stoi(cols[0]), cols[1], cols[2], head};
-            }
-            else
+            cur[0] = i;
+            int best = cur[0];
+            for (size_t j = 1; j <= b.size(); ++j)
             {
-                head = new Appointment{stoi(cols[0]), stoi(cols[1]), stoi(cols[2]), cols[3], head};
+                cur[j] = min({prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + (a[i - 1] != b[j - 1])});
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                    cur[j] = min(cur[j], before[j - 2] + 1);
+                best = min(best, cur[j]);
             }
+            if (best > bound)
+                return bound + 1;
+            swap(before, prev);
+            swap(prev, cur);
         }
+        return prev[b.size()];
     }
+};
+
+// ======== Routing ========
+// Dijkstra over the adjacency with scratch buffers kept between queries. A per-query epoch marks
+// which distance entries are current, so starting a search costs nothing however large the
+// network is, and a query only touches the nodes it actually settles.
+class Router
+{
+public:
+    explicit Router(const Adjacency &adj) : adj(adj) {}
 
-    void savePatients(const string &fn)
+    // Settle nodes from source in distance order until stop(v) holds for a settled node;
+    // returns that node, or -1 once everything reachable is settled
+    template <typename Stop>
+    int search(int source, Stop stop)
     {
-        ofstream f(fn);
-        f << "id,name,dob,gender\n";
-        for (auto *p = patients; p; p = p->next)
-            f << p->id << ',' << p->name << ',' << p->dob << ',' << p->gender << "\n";
+        begin();
+        reach(source, 0, -1);
+        while (!heap.empty())
+        {
+            pop_heap(heap.begin(), heap.end(), greater<>());
+            auto [d, v] = heap.back();
+            heap.pop_back();
+            if (d > dist[v])
+                continue; // Stale entry left by a later improvement
+            if (stop(v))
+                return v;
+            for (auto &e : adj.neighbours(v))
+                if (!seen(e.first) || d + e.second < dist[e.first])
+                    reach(e.first, d + e.second, v);
+        }
+        return -1;
     }
-    void saveDoctors(const string &fn)
+
+    // Valid for nodes settled by the last search
+    long long distanceTo(int v) const { return dist[v]; }
+    vector<int> pathTo(int v) const
     {
-        ofstream f(fn);
-        f << "id,name,specialization\n";
-        for (auto *d = doctors; d; d = d->next)
-            f << d->id << ',' << d->name << ',' << d->specialization << "\n";
+        vector<int> path;
+        for (; v != -1; v = parent[v])
+            path.push_back(v);
+        reverse(path.begin(), path.end());
+        return path;
     }
-    void saveAppointments(const string &fn)
+
+private:
+    const Adjacency &adj;
+    vector<long long> dist;
+    vector<int> parent;
+    vector<unsigned> stamp; // dist/parent of v belong to this query iff stamp[v] == epoch
+    unsigned epoch = 0;
+    vector<pair<long long, int>> heap;
+
+    void begin()
     {
-        ofstream f(fn);
-        f << "id,patientId,doctorId,date\n";
-        for (auto *a = appointments; a; a = a->next)
-            f << a->id << ',' << a->patientId << ',' << a->doctorId << ',' << a->date << "\n";
+        if (stamp.size() < adj.size())
+        {
+            dist.resize(adj.size());
+            parent.resize(adj.size());
+            stamp.resize(adj.size(), 0);
+        }
+        if (++epoch == 0)
+        {
+            fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+        heap.clear();
     }
-
-    void normalizeCounters()
+    bool seen(int v) const { return stamp[v] == epoch; }
+    void reach(int v, long long d, int from)
     {
-        for (auto *p = patients; p; p = p->next)
-            nextPatientId = max(nextPatientId, p->id + 1);
-        for (auto *d = doctors; d; d = d->next)
-            nextDoctorId = max(nextDoctorId, d->id + 1);
-        for (auto *a = appointments; a; a = a->next)
-            nextAppointmentId = max(nextAppointmentId, a->id + 1);
+        stamp[v] = epoch;
+        dist[v] = d;
+        parent[v] = from;
+        heap.push_back({d, v});
+        push_heap(heap.begin(), heap.end(), greater<>());
     }
 };
 
@@ -224,29 +1367,55 @@ class Graph
 {
 
 private:
+    WriteAheadLog wal{"registrations.wal"};
+    thread snapshotter;
+    atomic<bool> snapshotting{false};
+    thread namesBuilder; // Fills names after startup; joined before names is used
+    atomic<bool> namesReady{false};
+    vector<NameIndex::Entry> pendingNames; // Registered while namesBuilder was running
+
     bool areConnected(const string &a, const string &b)
     {
-        if (adj.find(a) == adj.end())
-            return false;
-        for (const auto &edge : adj[a])
-        {
-            if (edge.first == b)
-            {
-                return true;
-            }
-        }
-        return false;
+        int u = adj.find(a), v = adj.find(b);
+        return u >= 0 && v >= 0 && adj.connected(u, v);
     }
 
 public:
     unordered_map<string, Hospital *> nodes;
-    unordered_map<string, vector<pair<string, int>>> adj;
+    Adjacency adj;
+    Router router{adj}; // Scratch buffers shared by all route queries
+    SpecializationIndex specialists;
+    NameIndex names;
     int nextHospitalIndex = 1;
+    vector<pair<string, double>> loadPhases; // Startup phase name and milliseconds
 
     Graph()
     {
         loadHospitals();
+        auto t0 = chrono::steady_clock::now();
+        recoverLog();
+        loadPhases.push_back({"log replay", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count()});
+        t0 = chrono::steady_clock::now();
+        for (auto &kv : nodes)
+            for (auto *d = kv.second->doctors; d; d = d->next)
+                specialists.add(adj.find(kv.first), d);
+        loadPhases.push_back({"specializations", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count()});
+        t0 = chrono::steady_clock::now();
         loadConnections();
+        loadPhases.push_back({"connections", chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count()});
+
+        cout << "Loaded " << nodes.size() << " hospitals:";
+        for (auto &phase : loadPhases)
+            cout << " " << phase.first << " " << fixed << setprecision(1) << phase.second << " ms";
+        cout << "\n";
+        buildNames();
+    }
+    ~Graph()
+    {
+        if (snapshotter.joinable())
+            snapshotter.join();
+        if (namesBuilder.joinable())
+            namesBuilder.join();
     }
 
     // --- Node operations ---
@@ -260,6 +1429,8 @@ public:
         getline(cin, loc);
         string id = genId();
         nodes[id] = new Hospital(id, nm, loc);
+        nodes[id]->wal = &wal;
+        adj.intern(id);
         saveHospitals();
         saveConnections();
         cout << "Added: " << id << "\n";
@@ -274,17 +1445,12 @@ public:
             cout << "Not found.\n";
             return;
         }
+        finishNames(); // The builder may still be reading this hospital's lists
         delete nodes[id];
         nodes.erase(id);
-        adj.erase(id);
-        for (auto &kv : adj)
-        {
-            auto &v = kv.second;
-            v.erase(remove_if(v.begin(), v.end(),
-                              [&](auto &p)
-                              { return p.first == id; }),
-                    v.end());
-        }
+        specialists.removeHospital(adj.find(id));
+        names.removeHospital(adj.find(id));
+        adj.isolate(adj.find(id));
         saveHospitals();
         saveConnections();
         cout << "Deleted " << id << "\n";
@@ -333,8 +1499,7 @@ public:
             return;
         }
         int dist = readInt("Distance (km): ", 0);
-        adj[a].push_back({b, dist});
-        adj[b].push_back({a, dist});
+        adj.connect(adj.intern(a), adj.intern(b), dist);
         saveConnections();
         cout << "Connected " << a << " <-> " << b << "\n";
     }
@@ -345,21 +1510,15 @@ public:
             cout << "Invalid IDs.\n";
             return;
         }
-        auto &va = adj[a], &vb = adj[b];
-        int idxA = -1, idxB = -1;
-        for (int i = 0; i < va.size(); ++i)
-            if (va[i].first == b)
-                idxA = i;
-        for (int i = 0; i < vb.size(); ++i)
-            if (vb[i].first == a)
-                idxB = i;
-        if (idxA < 0 || idxB < 0)
+        int u = adj.find(a), v = adj.find(b);
+        int *d = u >= 0 && v >= 0 ? adj.distance(u, v) : nullptr;
+        if (!d)
         {
             cout << "No connection found.\n";
             return;
         }
         int nd = readInt("New distance (km): ", 0);
-        va[idxA].second = vb[idxB].second = nd;
+        adj.connect(u, v, nd);
         saveConnections();
         cout << "Updated " << a << "<->" << b << " to " << nd << "km\n";
     }
@@ -370,15 +1529,12 @@ public:
             cout << "Invalid IDs.\n";
             return;
         }
-        auto &va = adj[a], &vb = adj[b];
-        va.erase(remove_if(va.begin(), va.end(),
-                           [&](auto &p)
-                           { return p.first == b; }),
-                 va.end());
-        vb.erase(remove_if(vb.begin(), vb.end(),
-                           [&](auto &p)
-                           { return p.first == a; }),
-                 vb.end());
+        int u = adj.find(a), v = adj.find(b);
+        if (u < 0 || v < 0 || !adj.disconnect(u, v))
+        {
+            cout << "No connection found.\n";
+            return;
+        }
         saveConnections();
         cout << "Removed connection " << a << " <-> " << b << "\n";
     }
@@ -393,15 +1549,143 @@ public:
     void displayNetwork()
     {
         cout << "-- Network --\n";
-        for (auto &kv : adj)
+        for (int v = 0; v < (int)adj.size(); ++v)
         {
-            cout << kv.first << " -> ";
-            for (auto &e : kv.second)
-                cout << e.first << "(" << e.second << "km) ";
+            if (adj.neighbours(v).empty())
+                continue;
+            cout << adj.name(v) << " -> ";
+            for (auto &e : adj.neighbours(v))
+                cout << adj.name(e.first) << "(" << e.second << "km) ";
             cout << "\n";
         }
     }
 
+    // --- Routing ---
+    void shortestRoute()
+    {
+        cout << "From ID: ";
+        string a;
+        getline(cin, a);
+        cout << "To ID:   ";
+        string b;
+        getline(cin, b);
+        if (!nodes.count(a) || !nodes.count(b))
+        {
+            cout << "Invalid IDs.\n";
+            return;
+        }
+        int target = adj.find(b);
+        int found = router.search(adj.find(a), [&](int v)
+                                  { return v == target; });
+        if (found < 0)
+        {
+            cout << "No route between " << a << " and " << b << ".\n";
+            return;
+        }
+        printRoute(found);
+    }
+    void nearestWithSpecialization()
+    {
+        cout << "From ID: ";
+        string a;
+        getline(cin, a);
+        if (!nodes.count(a))
+        {
+            cout << "Not found.\n";
+            return;
+        }
+        cout << "Specialization: ";
+        string spec;
+        getline(cin, spec);
+        unordered_set<int> targets;
+        for (auto &p : specialists.find(spec))
+            targets.insert(p.hospital);
+        if (targets.empty())
+        {
+            cout << "No hospital has " << spec << ".\n";
+            return;
+        }
+        int found = router.search(adj.find(a), [&](int v)
+                                  { return targets.count(v) > 0; });
+        if (found < 0)
+        {
+            cout << "No reachable hospital has " << spec << ".\n";
+            return;
+        }
+        cout << "Nearest: " << adj.name(found) << " | " << nodes[adj.name(found)]->name << "\n";
+        printRoute(found);
+    }
+
+    void hospitalsWithSpecialization()
+    {
+        cout << "Specialization: ";
+        string spec;
+        getline(cin, spec);
+        const auto &found = specialists.find(spec);
+        cout << "-- Doctors with " << spec << " --\n";
+        for (auto &p : found)
+            cout << adj.name(p.hospital) << " | " << nodes[adj.name(p.hospital)]->name
+                 << " | D" << p.doctor->id << ": " << p.doctor->name << "\n";
+        if (found.empty())
+            cout << "None.\n";
+    }
+
+    // --- Name search ---
+    // Typeahead by name prefix; when nothing starts with the query, the closest spellings instead
+    void searchByName()
+    {
+        const size_t limit = 10;
+        cout << "Name or start of a name: ";
+        string query;
+        getline(cin, query);
+        finishNames();
+        auto t0 = chrono::steady_clock::now();
+        vector<NameIndex::Entry> found = names.prefix(query, limit);
+        vector<pair<int, NameIndex::Entry>> close;
+        if (found.empty())
+            close = names.fuzzy(query, limit);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        if (!found.empty())
+        {
+            cout << "-- Names starting with \"" << query << "\" --\n";
+            for (auto &e : found)
+                printPerson(e);
+        }
+        else if (!close.empty())
+        {
+            cout << "-- No name starts with \"" << query << "\"; closest spellings --\n";
+            for (auto &m : close)
+            {
+                printPerson(m.second);
+                cout << "   (" << m.first << (m.first == 1 ? " edit" : " edits") << ")\n";
+            }
+        }
+        else
+            cout << "No matches.\n";
+        cout << "(" << fixed << setprecision(2) << ms << " ms)\n";
+    }
+
+    // --- Registration ---
+    // Patients and doctors are registered through these so the search indexes see every one of them
+    int registerPatient(Hospital *h, const string &n, const string &d, const string &g)
+    {
+        int id = h->registerPatient(n, d, g);
+        if (id >= 0)
+            addName(adj.find(h->hospitalId), id, false, h->patients->name);
+        return id;
+    }
+    int registerDoctor(Hospital *h, const string &n, const string &spec)
+    {
+        int id = h->registerDoctor(n, spec);
+        if (id < 0)
+            return id;
+        int v = adj.find(h->hospitalId);
+        specialists.add(v, h->doctors);
+        addName(v, id, true, h->doctors->name);
+        return id;
+    }
+
     // --- Per-hospital management ---
     void manageHospital()
     {
@@ -427,9 +1711,11 @@ public:
                  << "8. Add Connection\n"
                  << "9. Update Connection\n"
                  << "10.Delete Connection\n"
-                 << "11.Go Back\n";
-            int c = readInt("Choose: ", 1, 11);
-            if (c == 11)
+                 << "11.Next Free Slot for Doctor\n"
+                 << "12.Doctor's Day Schedule\n"
+                 << "13.Go Back\n";
+            int c = readInt("Choose: ", 1, 13);
+            if (c == 13)
                 break;
             switch (c)
             {
@@ -444,7 +1730,11 @@ public:
                 cout << "Gender: ";
                 string g;
                 getline(cin, g);
-                cout << "Added Patient " << h->registerPatient(n, d, g) << "\n";
+                int id = registerPatient(h, n, d, g);
+                if (id < 0)
+                    cout << "Registration could not be saved.\n";
+                else
+                    cout << "Added Patient " << id << "\n";
                 break;
             }
             case 2:
@@ -455,17 +1745,34 @@ public:
                 cout << "Spec: ";
                 string s;
                 getline(cin, s);
-                cout << "Added Doctor " << h->registerDoctor(n, s) << "\n";
+                int id = registerDoctor(h, n, s);
+                if (id < 0)
+                    cout << "Registration could not be saved.\n";
+                else
+                    cout << "Added Doctor " << id << "\n";
                 break;
             }
             case 3:
             {
                 int pid = readInt("Patient ID: ", 1), did = readInt("Doctor ID: ", 1);
-                cout << "Date: ";
+                cout << "Time (YYYY-MM-DD HH:MM): ";
                 string dt;
                 getline(cin, dt);
                 int id = h->registerAppointment(pid, did, dt);
-                cout << (id < 0 ? "Invalid IDs" : "Added Appointment " + to_string(id)) << "\n";
+                if (id == -1)
+                    cout << "Invalid IDs\n";
+                else if (id == -2)
+                    cout << "Invalid time.\n";
+                else if (id == -3)
+                {
+                    long long t;
+                    parseSlot(dt, t);
+                    cout << "Doctor is already booked then; next free slot is " << formatSlot(h->nextFreeSlot(did, t)) << "\n";
+                }
+                else if (id == -4)
+                    cout << "Registration could not be saved.\n";
+                else
+                    cout << "Added Appointment " << id << "\n";
                 break;
             }
             case 4:
@@ -480,8 +1787,9 @@ public:
             case 7:
             {
                 cout << "-- Connections from " << hid << " --\n";
-                for (auto &e : adj[hid])
-                    cout << e.first << "(" << e.second << "km)\n";
+                if (adj.find(hid) >= 0)
+                    for (auto &e : adj.neighbours(adj.find(hid)))
+                        cout << adj.name(e.first) << "(" << e.second << "km)\n";
                 break;
             }
             case 8:
@@ -500,8 +1808,7 @@ public:
                     break;
                 }
                 int dist = readInt("Distance (km): ", 0);
-                adj[hid].push_back({other, dist});
-                adj[other].push_back({hid, dist});
+                adj.connect(adj.intern(hid), adj.intern(other), dist);
                 saveConnections();
                 cout << "Connected.\n";
                 break;
@@ -522,25 +1829,125 @@ public:
                 deleteConnection(hid, other);
                 break;
             }
+            case 11:
+            {
+                int did = readInt("Doctor ID: ", 1);
+                cout << "From (YYYY-MM-DD HH:MM): ";
+                string from;
+                getline(cin, from);
+                long long t;
+                if (!parseSlot(from, t))
+                {
+                    cout << "Invalid time.\n";
+                    break;
+                }
+                long long slot = h->nextFreeSlot(did, t);
+                cout << (slot < 0 ? "Invalid ID." : "Next free slot: " + formatSlot(slot)) << "\n";
+                break;
+            }
+            case 12:
+            {
+                int did = readInt("Doctor ID: ", 1);
+                cout << "Day (YYYY-MM-DD): ";
+                string day;
+                getline(cin, day);
+                long long t;
+                if (!parseDay(day, t))
+                {
+                    cout << "Invalid date.\n";
+                    break;
+                }
+                h->displayDaySchedule(did, t);
+                break;
+            }
             }
+            if (c <= 3)
+                maybeSnapshot();
         }
     }
 
 private:
+    // Index every name on a background thread so startup does not wait for it. The thread walks only
+    // the lists as they are now: registrations prepend new nodes and never change existing ones, and
+    // deleting a hospital waits for the thread first.
+    void buildNames()
+    {
+        vector<tuple<int, const Patient *, const Doctor *>> heads;
+        for (auto &kv : nodes)
+            heads.emplace_back(adj.find(kv.first), kv.second->patients, kv.second->doctors);
+        namesBuilder = thread([this, heads = move(heads)]()
+                              {
+            for (auto &h : heads)
+            {
+                for (auto *p = get<1>(h); p; p = p->next)
+                    names.add(get<0>(h), p->id, false, p->name);
+                for (auto *d = get<2>(h); d; d = d->next)
+                    names.add(get<0>(h), d->id, true, d->name);
+            }
+            namesReady = true; });
+    }
+
+    // Wait for the background build, then add what was registered meanwhile
+    void finishNames()
+    {
+        if (!namesBuilder.joinable())
+            return;
+        if (!namesReady)
+            cout << "(waiting for the name index)\n";
+        namesBuilder.join();
+        for (auto &e : pendingNames)
+            names.add(e.hospital, e.id, e.doctor, *e.name);
+        pendingNames.clear();
+    }
+
+    void addName(int hospital, int id, bool doctor, const string &name)
+    {
+        if (namesBuilder.joinable())
+            pendingNames.push_back({hospital, id, doctor, &name});
+        else
+            names.add(hospital, id, doctor, name);
+    }
+
+    void printPerson(const NameIndex::Entry &e)
+    {
+        cout << adj.name(e.hospital) << " | " << (e.doctor ? "Doctor D" : "Patient P") << e.id << ": " << *e.name << "\n";
+    }
+
+    // The route the last search found to v
+    void printRoute(int v)
+    {
+        vector<int> path = router.pathTo(v);
+        for (size_t i = 0; i < path.size(); ++i)
+            cout << (i ? " -> " : "Route: ") << adj.name(path[i]);
+        cout << " (" << router.distanceTo(v) << " km)\n";
+    }
+
     string genId()
     {
         return "H" + to_string(nextHospitalIndex++);
     }
 
     // -- hospitals.csv --
+    // The index is read first; each hospital's record files are then parsed on a worker pool
+    // and the finished hospitals are published into nodes in one step.
     void loadHospitals()
     {
+        auto t0 = chrono::steady_clock::now();
+        auto lap = [&t0]()
+        {
+            auto now = chrono::steady_clock::now();
+            double ms = chrono::duration<double, milli>(now - t0).count();
+            t0 = now;
+            return ms;
+        };
+
         ifstream f("hospitals.csv");
         if (!f)
             return;
         string line;
         getline(f, line);
         int maxIdx = 0;
+        vector<vector<string>> rows;
         while (getline(f, line))
         {
             stringstream ss(line);
@@ -549,9 +1956,38 @@ private:
             getline(ss, nm, ',');
             getline(ss, loc, ',');
             maxIdx = max(maxIdx, stoi(id.substr(1)));
-            nodes[id] = new Hospital(id, nm, loc);
+            rows.push_back({id, nm, loc});
         }
         nextHospitalIndex = maxIdx + 1;
+        loadPhases.push_back({"index", lap()});
+
+        // Hospitals differ in size, so workers claim the next unparsed one instead of fixed ranges
+        vector<Hospital *> loaded(rows.size(), nullptr);
+        atomic<size_t> next(0);
+        auto work = [&]()
+        {
+            for (size_t i = next++; i < rows.size(); i = next++)
+                loaded[i] = new Hospital(rows[i][0], rows[i][1], rows[i][2]);
+        };
+        unsigned threads = max(1u, min<unsigned>(thread::hardware_concurrency(), rows.size()));
+        vector<thread> pool;
+        for (unsigned w = 1; w < threads; ++w)
+            pool.emplace_back(work);
+        work();
+        for (auto &t : pool)
+            t.join();
+        loadPhases.push_back({"records (" + to_string(threads) + " threads)", lap()});
+
+        nodes.reserve(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            auto it = nodes.find(rows[i][0]);
+            if (it != nodes.end())
+                delete it->second; // A later row with the same ID wins, as before
+            nodes[rows[i][0]] = loaded[i];
+            adj.intern(rows[i][0]);
+        }
+        loadPhases.push_back({"publish", lap()});
     }
     void saveHospitals()
     {
@@ -561,6 +1997,80 @@ private:
             f << kv.first << ',' << kv.second->name << ',' << kv.second->location << "\n";
     }
 
+    // -- registrations.wal --
+    // Snapshot CSVs, then the rotated log an interrupted snapshot left behind, then the live log
+    void recoverLog()
+    {
+        auto apply = [this](const string &line)
+        {
+            stringstream ss(line);
+            vector<string> cols;
+            string tok;
+            while (getline(ss, tok, ','))
+                cols.push_back(tok);
+            if (cols.size() < 3 || cols[0].size() != 1 || !nodes.count(cols[1]))
+                return;
+            try
+            {
+                nodes[cols[1]]->applyRecord(cols[0][0], vector<string>(cols.begin() + 2, cols.end()));
+            }
+            catch (...)
+            {
+                // A record that passed its checksum but does not parse, e.g. from an older build
+            }
+        };
+        bool interrupted = WriteAheadLog::replay(wal.rotatedPath(), apply);
+        WriteAheadLog::replay(wal.currentPath(), apply);
+        for (auto &kv : nodes)
+            kv.second->wal = &wal;
+
+        // Finish the interrupted snapshot; until it succeeds the rotated log is kept and no rotation happens
+        if (interrupted)
+        {
+            bool ok = true;
+            for (auto &kv : nodes)
+                if (kv.second->logged)
+                    ok = Hospital::saveSnapshot(kv.second->snapshot()) && ok;
+            if (ok && syncDirectory())
+                wal.removeRotated();
+            else
+                cerr << "Snapshot failed; " << wal.rotatedPath() << " is kept for the next start.\n";
+        }
+    }
+
+    // Once the log is large, snapshot changed hospitals in the background and continue in a fresh log
+    void maybeSnapshot()
+    {
+        if (wal.size() < WAL_SNAPSHOT_BYTES || snapshotting)
+            return;
+        if (snapshotter.joinable())
+            snapshotter.join();
+        // Registrations happen on this thread, so the lists copied below hold exactly the rotated records
+        if (!wal.rotate())
+            return;
+        vector<Hospital::Snapshot> snaps;
+        for (auto &kv : nodes)
+        {
+            if (kv.second->logged)
+            {
+                snaps.push_back(kv.second->snapshot());
+                kv.second->logged = false;
+            }
+        }
+        snapshotting = true;
+        snapshotter = thread([this, snaps = move(snaps)]()
+                             {
+            bool ok = true;
+            for (auto &snap : snaps)
+                ok = Hospital::saveSnapshot(snap) && ok;
+            // The rotated log goes only once every file it covers is written, fsynced, renamed and the rename durable
+            if (ok && syncDirectory())
+                wal.removeRotated();
+            else
+                cerr << "Snapshot failed; " << wal.rotatedPath() << " is kept for the next start.\n";
+            snapshotting = false; });
+    }
+
     // -- connections.csv --
     void loadConnections()
     {
@@ -578,22 +2088,19 @@ private:
             getline(ss, b, ',');
             ss >> d;
             if (nodes.count(a) && nodes.count(b))
-            {
-                adj[a].push_back({b, d});
-                adj[b].push_back({a, d});
-            }
+                adj.connect(adj.intern(a), adj.intern(b), d);
         }
     }
     void saveConnections()
     {
         ofstream f("connections.csv");
         f << "from,to,distance\n";
-        for (auto &kv : adj)
+        for (int v = 0; v < (int)adj.size(); ++v)
         {
-            const string &a = kv.first;
-            for (auto &e : kv.second)
+            const string &a = adj.name(v);
+            for (auto &e : adj.neighbours(v))
             {
-                const string &b = e.first;
+                const string &b = adj.name(e.first);
                 int d = e.second;
                 if (a < b)
                     f << a << ',' << b << ',' << d << "\n";
@@ -616,9 +2123,13 @@ int main()
              << "5. List Hospitals\n"
              << "6. View Network\n"
              << "7. Manage Hospital\n"
-             << "8. Exit\n";
-        int choice = readInt("Choose: ", 1, 8);
-        if (choice == 8)
+             << "8. Shortest Route\n"
+             << "9. Nearest Hospital with Specialization\n"
+             << "10.Hospitals with Specialization\n"
+             << "11.Search by Name\n"
+             << "12.Exit\n";
+        int choice = readInt("Choose: ", 1, 12);
+        if (choice == 12)
             break;
         switch (choice)
         {
@@ -643,6 +2154,18 @@ int main()
         case 7:
             graph.manageHospital();
             break;
+        case 8:
+            graph.shortestRoute();
+            break;
+        case 9:
+            graph.nearestWithSpecialization();
+            break;
+        case 10:
+            graph.hospitalsWithSpecialization();
+            break;
+        case 11:
+            graph.searchByName();
+            break;
         }
     }
     cout << "Goodbye!\n";